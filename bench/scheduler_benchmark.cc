@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include <boost/format.hpp>
+#include "deck/deck.h"
+#include "deck/leitner_scheduler.h"
+
+// Times LeitnerScheduler::SelectRound over a deck of a million pairs, answering a fifth of the selected pairs with
+// errors so that the review heap fills up as it would in a long game.
+// Usage: `./scheduler_benchmark [pair count] [round count]`.
+
+using namespace cross_language_match;
+
+static const int kDefaultPairCount = 1000000;
+static const int kDefaultRoundCount = 2000;
+static const int kPairsPerRound = 12;
+static const unsigned int kSeed = 1;
+
+static double GetElapsedMs(std::chrono::steady_clock::time_point start_time) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+}
+
+int main(int argc, char **argv) {
+
+  int pair_count = argc > 1 ? atoi(argv[1]) : kDefaultPairCount;
+  int round_count = argc > 2 ? atoi(argv[2]) : kDefaultRoundCount;
+
+  std::map<std::string, std::string> word_pairs;
+  for (int i = 0; i < pair_count; i++) {
+    word_pairs[boost::str(boost::format("left%07d") % i)] = boost::str(boost::format("right%07d") % i);
+  }
+
+  auto start_time = std::chrono::steady_clock::now();
+  Deck *deck = new Deck(word_pairs, kSeed);
+  word_pairs.clear();
+  LeitnerScheduler *scheduler = new LeitnerScheduler(deck);
+  double build_ms = GetElapsedMs(start_time);
+
+  std::mt19937 random_engine(kSeed);
+  std::bernoulli_distribution answered_with_errors(0.2);
+  std::vector<int> pair_indices;
+  double total_select_ms = 0;
+  double slowest_select_ms = 0;
+  int played_round_count = 0;
+  for (; played_round_count < round_count && !scheduler->IsComplete(); played_round_count++) {
+
+    pair_indices.clear();
+    start_time = std::chrono::steady_clock::now();
+    scheduler->SelectRound(kPairsPerRound, &pair_indices);
+    double select_ms = GetElapsedMs(start_time);
+    total_select_ms += select_ms;
+    slowest_select_ms = std::max(slowest_select_ms, select_ms);
+
+    for (int pair_index : pair_indices) {
+      scheduler->RecordResult(pair_index, answered_with_errors(random_engine) ? 1 : 0);
+    }
+
+  }
+
+  printf("Built a %d pair deck and its scheduler in %.1f ms\n", pair_count, build_ms);
+  printf("Selected %d rounds of %d pairs: %.4f ms per round on average, %.4f ms at most\n",
+         played_round_count,
+         kPairsPerRound,
+         played_round_count > 0 ? total_select_ms / played_round_count : 0.0,
+         slowest_select_ms);
+
+  delete scheduler;
+  scheduler = nullptr;
+  delete deck;
+  deck = nullptr;
+  return 0;
+
+}
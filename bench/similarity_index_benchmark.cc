@@ -0,0 +1,67 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <string>
+#include <sys/resource.h>
+#include "deck/deck.h"
+#include "deck/similarity_index.h"
+
+// Builds a SimilarityIndex over a deck of 100k words and reports the time and memory it takes. The words recombine a
+// small set of Spanish-like syllables, so they are far denser in near matches than a real word list and the numbers
+// are an upper bound: `./similarity_index_benchmark [word count]`.
+
+using namespace cross_language_match;
+
+static const int kDefaultWordCount = 100000;
+static const unsigned int kSeed = 1;
+static const char *const kSyllables[] = {
+    "a", "ba", "ca", "da", "de", "do", "e", "es", "ga", "gar", "i", "la", "le", "li", "llo", "lu", "ma", "me", "mi",
+    "na", "ne", "no", "o", "pa", "pe", "po", "que", "ra", "re", "ri", "ro", "sa", "se", "so", "ta", "te", "ti", "to",
+    "tra", "u", "va", "ve", "za"
+};
+
+// Peak resident set size of the process in KB, as Linux reports it
+static long GetPeakResidentKb() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+int main(int argc, char **argv) {
+
+  int word_count = argc > 1 ? atoi(argv[1]) : kDefaultWordCount;
+
+  std::mt19937 random_engine(kSeed);
+  std::uniform_int_distribution<int> syllable_count(2, 4);
+  std::uniform_int_distribution<int> syllable(0, sizeof(kSyllables) / sizeof(kSyllables[0]) - 1);
+  std::map<std::string, std::string> word_pairs;
+  while ((int) word_pairs.size() < word_count) {
+    std::string word;
+    for (int i = syllable_count(random_engine); i > 0; i--) {
+      word += kSyllables[syllable(random_engine)];
+    }
+    word_pairs[word] = std::to_string(word_pairs.size());
+  }
+  Deck *deck = new Deck(word_pairs, kSeed);
+  word_pairs.clear();
+
+  long peak_resident_kb_before = GetPeakResidentKb();
+  auto start_time = std::chrono::steady_clock::now();
+  SimilarityIndex *similarity_index = new SimilarityIndex(deck);
+  double build_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+  long peak_resident_kb_after = GetPeakResidentKb();
+
+  printf("Built a similarity index over %d words in %.1f ms\n", deck->GetPairCount(), build_ms);
+  printf("The index keeps %d KB; building it raised peak resident memory by %ld KB\n",
+         (int) (similarity_index->GetMemoryBytes() / 1024),
+         peak_resident_kb_after - peak_resident_kb_before);
+
+  delete similarity_index;
+  similarity_index = nullptr;
+  delete deck;
+  deck = nullptr;
+  return 0;
+
+}
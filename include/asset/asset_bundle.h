@@ -0,0 +1,38 @@
+#include <map>
+#include <string>
+#include <vector>
+
+#ifndef CROSSLANGUAGEMATCH_INCLUDE_ASSET_ASSET_BUNDLE_H_
+#define CROSSLANGUAGEMATCH_INCLUDE_ASSET_ASSET_BUNDLE_H_
+
+namespace cross_language_match {
+
+// Where the build puts the gzip-compressed assets, relative to the page hosting the game
+static const char *kAssetBundleUrl = "bundle";
+
+// Assets served gzip-compressed next to the game, each fetched and inflated the first time it is asked for rather than
+// all of them before main runs. Inflated bytes are kept for the life of the bundle, so that fonts and other readers
+// can use them in place.
+class AssetBundle {
+
+ public:
+  explicit AssetBundle(std::string base_url);
+
+  AssetBundle(const AssetBundle &) = delete;
+  AssetBundle &operator=(const AssetBundle &) = delete;
+
+  // Path relative to the assets directory, e.g. "fonts/OpenSans-Regular.ttf"; throws if the asset cannot be fetched
+  // or is not valid gzip data
+  const std::vector<char> &GetAsset(const std::string &asset_path);
+
+ private:
+  void Inflate(const std::string &asset_path, const char *compressed, int compressed_size, std::vector<char> *asset);
+
+  const std::string base_url_;
+  std::map<std::string, std::vector<char>> assets_;
+
+};
+
+}
+
+#endif //CROSSLANGUAGEMATCH_INCLUDE_ASSET_ASSET_BUNDLE_H_
@@ -0,0 +1,63 @@
+#include <vector>
+#include "text/interactive_text_group.h"
+
+#ifndef CROSSLANGUAGEMATCH_INCLUDE_BOARD_MATCH_BOARD_H_
+#define CROSSLANGUAGEMATCH_INCLUDE_BOARD_MATCH_BOARD_H_
+
+namespace cross_language_match {
+
+// Holds the state of a single round as parallel arrays indexed by slot, where each slot is one word shown on screen.
+// Word IDs are assigned by the caller; two slots in the same column showing the same string should share an ID, so
+// that linking to either of them is accepted as correct. A link is judged from its left slot, and running counts of
+// linked and correct pairs are maintained on every link change so progress queries never rescan the board.
+class MatchBoard {
+
+ public:
+  static const int kNoSlot = -1;
+
+  void Clear();
+  int AddSlot(int word_id, InteractiveTextGroup column, int expected_partner_word_id);
+  int GetSlotCount();
+
+  int GetWordId(int slot);
+  // For words edited mid-round; the slot must be unlinked while its IDs change, so that the counts stay right
+  void SetWordId(int slot, int word_id);
+  void SetExpectedPartnerWordId(int slot, int expected_partner_word_id);
+  InteractiveTextGroup GetColumn(int slot);
+
+  void Link(int slot, int other_slot);
+  void Unlink(int slot);
+  int GetLink(int slot);
+  bool IsLinked(int slot);
+  bool IsLinkCorrect(int slot);
+
+  int GetPairCount();
+  int GetLinkedPairCount();
+  int GetCorrectPairCount();
+  bool AreAllPairsLinked();
+  bool AreAllPairsLinkedAndCorrect();
+
+  void AddHighlight(int slot);
+  void RemoveHighlight(int slot);
+  bool IsHighlighted(int slot);
+  int GetHighlightedSlot(InteractiveTextGroup column);
+
+ private:
+  std::vector<int> word_ids_;
+  std::vector<InteractiveTextGroup> columns_;
+  std::vector<int> links_;
+  std::vector<bool> highlighted_;
+  std::vector<int> expected_partner_word_ids_;
+
+  // At most one slot per column is highlighted at a time, so the highlighted slot of each column is tracked directly
+  int highlighted_slot_per_column_[2] = {kNoSlot, kNoSlot};
+
+  int pair_count_ = 0;
+  int linked_pair_count_ = 0;
+  int correct_pair_count_ = 0;
+
+};
+
+}
+
+#endif //CROSSLANGUAGEMATCH_INCLUDE_BOARD_MATCH_BOARD_H_
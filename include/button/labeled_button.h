@@ -10,6 +10,8 @@ class LabeledButton : public RectangularButton {
  public:
   LabeledButton(RectangularButton button, Text *label);
   void Render() override;
+  // The label is not owned, and can be swapped for another while the button is shown
+  void SetLabel(Text *label);
  private:
   Text *label_;
 };
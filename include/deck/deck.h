@@ -0,0 +1,172 @@
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+#ifndef CROSSLANGUAGEMATCH_INCLUDE_DECK_DECK_H_
+#define CROSSLANGUAGEMATCH_INCLUDE_DECK_DECK_H_
+
+namespace cross_language_match {
+
+class FileWordLoader;
+
+// All word pairs of a game, stored as NUL-terminated strings packed into one character buffer, together with a
+// random draw order. The draw order is a Fisher-Yates shuffle performed lazily: each draw swaps a random undrawn pair
+// into place, so drawing N pairs costs O(N) and reshuffling only rewinds the cursor, regardless of deck size.
+//
+// A compiled deck whose strings exceed the memory budget is opened in paged mode: only the draw order is resident,
+// and the strings, offsets and word IDs are read from the file in pages of kPairsPerPage pairs as they are asked for,
+// keeping the most recently used pages up to the budget. A string returned in paged mode stays valid until strings
+// from two other pages have been asked for.
+//
+// A plain word file with a line index can be opened the same way, parsing each page's lines as they are needed. Such a
+// deck skips the map the loader would otherwise build: every line is a pair, in file order, duplicates included, and
+// word IDs are hashes of the words rather than pair indices. It cannot be written out as a compiled deck.
+//
+// A fully loaded deck can be edited while a game is in progress. Pairs are never renumbered: an added pair is
+// appended and joins the undrawn part of the draw order, and a replaced string is appended while the old one is left
+// in the buffer, unreferenced, so indices and word IDs held by the scheduler and the board stay valid.
+class Deck {
+
+ public:
+  static const int kPairsPerPage = 256;
+  static const std::size_t kDefaultMemoryBudgetBytes = 8 * 1024 * 1024;
+  static const int kNewWordId = -1;
+
+  Deck(const std::map<std::string, std::string> &word_pairs, unsigned int seed);
+  ~Deck();
+
+  Deck(const Deck &) = delete;
+  Deck &operator=(const Deck &) = delete;
+
+  // Compiled decks hold the packed strings and word IDs, so loading one skips parsing and interning entirely.
+  // Returns nullptr if the file is missing, malformed, or does not hash to expected_content_hash.
+  static Deck *ReadCompiled(const std::string &path,
+                            uint64_t expected_content_hash,
+                            unsigned int seed,
+                            std::size_t memory_budget_bytes = kDefaultMemoryBudgetBytes);
+  // For callers that address compiled decks by something other than their content, and accept whichever deck the
+  // file holds
+  static Deck *ReadCompiledUnchecked(const std::string &path,
+                                     unsigned int seed,
+                                     std::size_t memory_budget_bytes = kDefaultMemoryBudgetBytes);
+  // Takes ownership of the loader, whose line index must already be open
+  static Deck *OpenLineIndexed(FileWordLoader *line_loader,
+                               unsigned int seed,
+                               std::size_t memory_budget_bytes = kDefaultMemoryBudgetBytes);
+  bool WriteCompiled(const std::string &path);
+  uint64_t GetContentHash();
+
+  bool IsPaged();
+  uint64_t GetStringBytes();
+  // Index arrays plus whatever strings are resident
+  std::size_t GetResidentBytes();
+  std::size_t GetPeakResidentBytes();
+  int GetPageLoadCount();
+
+  // Draw order, cursor and random engine; together with the compiled deck this restores the deck exactly
+  bool WriteState(FILE *file);
+  bool ReadState(FILE *file);
+
+  int GetPairCount();
+  const char *GetLeftWord(int pair_index);
+  const char *GetRightWord(int pair_index);
+
+  // Pairs showing the same string on a side share that side's word ID
+  int GetLeftWordId(int pair_index);
+  int GetRightWordId(int pair_index);
+
+  int Draw(int count, std::vector<int> *pair_indices);
+  // Draws the given pair next instead of a random one; false if it has already been drawn
+  bool DrawPair(int pair_index);
+  int GetRemainingCount();
+  void Reshuffle();
+
+  // Shuffles using the deck's own engine, so a whole game is reproducible from the deck seed
+  void Shuffle(std::vector<int> *values);
+
+  // Edits; not available in paged mode. The deck keeps no index of its strings, so the caller passes the ID of a pair
+  // already showing the same string, or kNewWordId for a string no other pair shows.
+  int AddPair(const std::string &left_word, const std::string &right_word, int left_word_id, int right_word_id);
+  void SetRightWord(int pair_index, const std::string &right_word, int right_word_id);
+
+ private:
+
+  struct Page {
+    int page_index;
+    int first_pair;
+    uint64_t first_character;
+    std::vector<uint32_t> string_offsets;
+    std::vector<int> left_word_ids;
+    std::vector<int> right_word_ids;
+    std::vector<char> characters;
+    uint64_t last_use;
+  };
+
+  // Location of one of the compiled deck's arrays within the page file
+  struct PagedSection {
+    off_t offset;
+    uint64_t count;
+  };
+
+  explicit Deck(unsigned int seed);
+  static Deck *ReadCompiled(const std::string &path,
+                            const uint64_t *expected_content_hash,
+                            unsigned int seed,
+                            std::size_t memory_budget_bytes);
+  static bool SkipSection(FILE *file, std::size_t element_size, PagedSection *section);
+  bool IsIndexValid();
+  const char *GetString(int string_index);
+  const Page &GetPage(int page_index);
+  void LoadPage(int page_index, Page *page);
+  void LoadLinePage(int page_index, Page *page);
+  void ReadSection(const PagedSection &section, uint64_t first, uint64_t count, std::size_t element_size, void *out);
+  bool WriteSection(FILE *file, const PagedSection &section, std::size_t element_size);
+  std::size_t GetIndexBytes();
+  void AddString(const std::string &word);
+  void ResetDrawOrder();
+  void SwapDrawPositions(int position, int other_position);
+  void AssignWordIds(int side, std::vector<int> *word_ids);
+
+  std::vector<char> characters_;
+  // Offset of the left word of pair i is at 2 * i, and of its right word at 2 * i + 1
+  std::vector<uint32_t> string_offsets_;
+  std::vector<int> left_word_ids_;
+  std::vector<int> right_word_ids_;
+  int pair_count_ = 0;
+  uint64_t content_hash_ = 0;
+  // Edits only mark the hash stale, so a batch of them is hashed once
+  bool content_hash_is_stale_ = false;
+  // Strings new to the deck after an edit take IDs counting down from here, clear of any pair index
+  int next_edited_word_id_ = INT32_MAX;
+
+  // Paged mode only; the four arrays above are then empty
+  FILE *page_file_ = nullptr;
+  PagedSection paged_characters_ = {0, 0};
+  PagedSection paged_string_offsets_ = {0, 0};
+  PagedSection paged_left_word_ids_ = {0, 0};
+  PagedSection paged_right_word_ids_ = {0, 0};
+  // Paged from a word file instead, when set
+  FileWordLoader *line_loader_ = nullptr;
+  std::size_t memory_budget_bytes_ = kDefaultMemoryBudgetBytes;
+  std::vector<Page> resident_pages_;
+  std::size_t resident_page_bytes_ = 0;
+  std::size_t peak_resident_page_bytes_ = 0;
+  uint64_t page_use_counter_ = 0;
+  int page_load_count_ = 0;
+
+  std::vector<int> draw_order_;
+  int draw_cursor_ = 0;
+  // Position of each pair in draw_order_; built on the first DrawPair, since plain draws have no need of it
+  std::vector<int> draw_positions_;
+  std::mt19937 random_engine_;
+
+};
+
+}
+
+#endif //CROSSLANGUAGEMATCH_INCLUDE_DECK_DECK_H_
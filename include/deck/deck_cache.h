@@ -0,0 +1,60 @@
+#include <cstdint>
+#include <string>
+#include "deck/deck.h"
+
+#ifndef CROSSLANGUAGEMATCH_INCLUDE_DECK_DECK_CACHE_H_
+#define CROSSLANGUAGEMATCH_INCLUDE_DECK_DECK_CACHE_H_
+
+namespace cross_language_match {
+
+// Lives in persistent storage, so in the browser it survives reloads through IDBFS
+static const char *kDeckCacheDirectory = "/persistent/deck_cache";
+
+// Compiled decks keyed by the XXH64 of the file they were parsed from, so that loading the same file again skips
+// parsing entirely. The cache is bounded by the total size of its decks; when storing a deck pushes it over the
+// bound, the least recently used decks are removed. Hit, miss and eviction counts persist alongside the decks. Decks
+// whose strings exceed the memory budget are opened paged, straight from their cache file.
+class DeckCache {
+
+ public:
+  static const uint64_t kDefaultMaxSizeBytes = 64ULL * 1024 * 1024;
+
+  explicit DeckCache(std::string directory,
+                     uint64_t max_size_bytes = kDefaultMaxSizeBytes,
+                     std::size_t deck_memory_budget_bytes = Deck::kDefaultMemoryBudgetBytes);
+
+  // Hashes the whole file; returns false if it cannot be read
+  static bool HashSourceFile(const std::string &path, uint64_t *source_hash);
+
+  // Returns nullptr on a miss
+  Deck *Find(uint64_t source_hash, unsigned int seed);
+  bool Store(uint64_t source_hash, Deck *deck);
+  // Like Find, but not counted as a lookup; for reopening a deck that was just stored
+  Deck *Open(uint64_t source_hash, unsigned int seed);
+
+  std::size_t GetDeckMemoryBudgetBytes();
+
+  uint64_t GetHitCount();
+  uint64_t GetMissCount();
+  uint64_t GetEvictionCount();
+
+ private:
+
+  std::string GetDeckPath(uint64_t source_hash);
+  void EvictToSize(const std::string &kept_path);
+  void ReadStats();
+  void WriteStats();
+
+  const std::string directory_;
+  const uint64_t max_size_bytes_;
+  const std::size_t deck_memory_budget_bytes_;
+
+  uint64_t hit_count_ = 0;
+  uint64_t miss_count_ = 0;
+  uint64_t eviction_count_ = 0;
+
+};
+
+}
+
+#endif //CROSSLANGUAGEMATCH_INCLUDE_DECK_DECK_CACHE_H_
@@ -0,0 +1,96 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "deck/deck.h"
+
+#ifndef CROSSLANGUAGEMATCH_INCLUDE_DECK_DECK_WATCHER_H_
+#define CROSSLANGUAGEMATCH_INCLUDE_DECK_DECK_WATCHER_H_
+
+namespace cross_language_match {
+
+// Pairs touched by one round of edits, by deck pair index
+struct DeckEdit {
+  std::vector<int> added_pairs;
+  // The right word of these pairs was replaced
+  std::vector<int> changed_pairs;
+  std::vector<int> removed_pairs;
+};
+
+// Follows the plain word file a fully loaded deck was built from and edits the deck to match it as the file changes.
+// The file is polled by size and modification time. A changed file is read once, hashing each line without parsing
+// it, and compared with the line hashes seen last time: the unchanged lines at either end are skipped outright, and
+// the lines in between are matched by hash, so that only lines that are actually new get parsed and the work beyond
+// the read scales with the size of the edit rather than the size of the file.
+//
+// A new line whose left word belongs to a pair whose line is gone changes that pair's right word; any other new line
+// adds a pair, and the remaining pairs whose lines are gone are removed. As with the loader, a line repeating the left
+// word of a pair already in the deck is ignored.
+class DeckWatcher {
+
+ public:
+  static const uint32_t kDefaultPollIntervalMs = 1000;
+
+  DeckWatcher(std::string file_path, Deck *deck, uint32_t poll_interval_ms = kDefaultPollIntervalMs);
+
+  // Looks at the file at most once per poll interval. Returns true if it had changed and the deck now matches it; a
+  // file that fails to parse leaves the deck as it was until the file changes again.
+  bool Poll(uint32_t now_ms, DeckEdit *edit);
+
+ private:
+
+  static const int kNoPair = -1;
+
+  struct HashedPair {
+    uint64_t hash;
+    int pair_index;
+    bool operator<(const HashedPair &other) const {
+      return hash < other.hash;
+    }
+  };
+
+  struct ScannedLine {
+    uint64_t hash;
+    uint64_t offset;
+    uint32_t length;
+    int line_index;
+    // Repeated lines stay in file order, so that the first of them is the one matched
+    bool operator<(const ScannedLine &other) const {
+      return hash != other.hash ? hash < other.hash : line_index < other.line_index;
+    }
+  };
+
+  static uint64_t HashLine(const char *left_word, const char *right_word);
+  static void MatchLines(std::vector<HashedPair> *known_pairs,
+                         std::vector<ScannedLine> *lines,
+                         std::vector<int> *line_pairs,
+                         std::vector<bool> *vanished,
+                         std::vector<ScannedLine> *unknown_lines);
+  static void Insert(std::vector<HashedPair> *hashed_pairs, std::vector<HashedPair> *additions);
+  static void Erase(std::vector<HashedPair> *hashed_pairs, const std::vector<bool> &erased_pairs);
+  bool HasFileChanged();
+  bool ScanFile(std::vector<ScannedLine> *lines);
+  bool ReadLines(const std::vector<ScannedLine> &lines, std::vector<std::string> *line_texts);
+  int FindPairByLeftWord(const std::string &left_word);
+  int FindRightWordId(const std::string &right_word);
+
+  std::string file_path_;
+  Deck *deck_;
+  const uint32_t poll_interval_ms_;
+  uint32_t last_poll_ms_ = 0;
+  uint64_t file_size_ = 0;
+  int64_t file_modification_time_ns_ = 0;
+
+  // The file as last seen: the hash of each line, and the pair it holds, or kNoPair for a repeated left word
+  std::vector<uint64_t> line_hashes_;
+  std::vector<int> line_pairs_;
+
+  // Pairs still in the file, sorted by the hash of their left word
+  std::vector<HashedPair> pairs_by_left_word_;
+  // Every pair, sorted by the hash of its right word; gives new strings the word ID of a pair already showing them
+  std::vector<HashedPair> pairs_by_right_word_;
+
+};
+
+}
+
+#endif //CROSSLANGUAGEMATCH_INCLUDE_DECK_DECK_WATCHER_H_
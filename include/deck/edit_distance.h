@@ -0,0 +1,16 @@
+#include <cstddef>
+
+#ifndef CROSSLANGUAGEMATCH_INCLUDE_DECK_EDIT_DISTANCE_H_
+#define CROSSLANGUAGEMATCH_INCLUDE_DECK_EDIT_DISTANCE_H_
+
+namespace cross_language_match {
+
+// Levenshtein distance between two byte strings, or bound + 1 if it exceeds bound. Strings of up to 64 bytes use
+// Myers' bit-parallel algorithm, which advances a whole column of the distance matrix with a few 64-bit operations
+// per byte of the other string; longer strings fall back to the banded dynamic programming recurrence. Multi-byte
+// UTF-8 characters count as one edit per differing byte.
+int BoundedEditDistance(const char *a, std::size_t a_length, const char *b, std::size_t b_length, int bound);
+
+}
+
+#endif //CROSSLANGUAGEMATCH_INCLUDE_DECK_EDIT_DISTANCE_H_
@@ -0,0 +1,92 @@
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <vector>
+#include "deck/deck.h"
+#include "deck/similarity_index.h"
+
+#ifndef CROSSLANGUAGEMATCH_INCLUDE_DECK_LEITNER_SCHEDULER_H_
+#define CROSSLANGUAGEMATCH_INCLUDE_DECK_LEITNER_SCHEDULER_H_
+
+namespace cross_language_match {
+
+// Chooses the pairs of each round with a Leitner system. Time is measured in rounds. A pair answered without errors
+// moves up one box and comes back after 2^box rounds, until it reaches the retirement box and leaves the game; a pair
+// answered with errors drops back to box 0 and is due again in the next round.
+//
+// Pairs that have never been shown are drawn from the deck's shuffled order. Pairs waiting for review sit in a binary
+// heap ordered by due round, then by error count, so selecting k pairs costs O(k log n) however large the deck is.
+//
+// With a similarity index, never-seen pairs are drawn in clusters instead: each pair drawn at random brings its unseen
+// neighbours with it, so that a round's words are easy to confuse.
+//
+// Pairs added to the deck mid-game start unseen; removed pairs are retired on the spot and are dropped from the heap
+// and the draw order only when they reach the front.
+class LeitnerScheduler {
+
+ public:
+  static const int kDefaultRetirementBox = 2;
+
+  explicit LeitnerScheduler(Deck *deck, int retirement_box = kDefaultRetirementBox);
+
+  // Starts the next round and appends up to count pair indices for it. It does no I/O; callers time and log it.
+  int SelectRound(int count, std::vector<int> *pair_indices);
+  void RecordResult(int pair_index, int error_count);
+  // Carries over mistakes from earlier sessions, so that pairs with a history of errors are reviewed first
+  void AddHistoricalErrors(int pair_index, int error_count);
+  // Asked for a pair's earlier mistakes when the pair is first drawn, so that a large deck's history does not have to
+  // be matched against every pair up front
+  void SetHistoricalErrorSource(std::function<int(int pair_index)> historical_error_source);
+  // Not owned; nullptr returns to plain random draws
+  void SetSimilarityIndex(SimilarityIndex *similarity_index);
+  // Follows deck edits; AddPair is called once for each pair appended to the deck
+  void AddPair();
+  void RemovePair(int pair_index);
+  bool IsComplete();
+  int GetCurrentRound();
+  // Pairs that have been answered and wait for a later round
+  int GetReviewCount();
+
+  bool WriteState(FILE *file);
+  bool ReadState(FILE *file);
+
+ private:
+
+  enum PairState : uint8_t {
+    UNSEEN = 0,
+    IN_ROUND = 1,
+    SCHEDULED = 2,
+    RETIRED = 3
+  };
+
+  void DrawPairs(int count, std::vector<int> *pair_indices);
+  void DrawSimilarPairs(int count, std::vector<int> *pair_indices);
+  void Schedule(int pair_index, int due_round);
+  int PopReview();
+  bool HasReview();
+  bool ReviewIsDue();
+
+  // Comparator for the std heap functions, which keep the greatest element on top; the "greatest" review is the one
+  // due soonest, with more errors breaking ties
+  bool IsReviewedAfter(int pair_index, int other_pair_index);
+
+  Deck *deck_;
+  std::function<int(int pair_index)> historical_error_source_;
+  SimilarityIndex *similarity_index_ = nullptr;
+  const int retirement_box_;
+  int current_round_ = 0;
+  int retired_count_ = 0;
+
+  // Per-pair state, indexed by deck pair index
+  std::vector<PairState> states_;
+  std::vector<uint8_t> boxes_;
+  std::vector<int32_t> due_rounds_;
+  std::vector<uint16_t> error_counts_;
+
+  std::vector<int> review_heap_;
+
+};
+
+}
+
+#endif //CROSSLANGUAGEMATCH_INCLUDE_DECK_LEITNER_SCHEDULER_H_
@@ -0,0 +1,39 @@
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "deck/deck.h"
+
+#ifndef CROSSLANGUAGEMATCH_INCLUDE_DECK_SIMILARITY_INDEX_H_
+#define CROSSLANGUAGEMATCH_INCLUDE_DECK_SIMILARITY_INDEX_H_
+
+namespace cross_language_match {
+
+// For each pair, the pairs whose left words are spelled most alike, such as lugar and llegar, for rounds where the
+// words on screen are easy to confuse.
+//
+// Comparing every word with every other is quadratic, so candidates come from locality-sensitive hashing instead:
+// each word's set of character bigrams is summarised by a MinHash signature, and words whose signatures agree on all
+// rows of any one band land in the same bucket. Only words sharing a bucket are compared, by edit distance bounded
+// to about a third of the shorter word. Letters are compared without regard to ASCII case.
+class SimilarityIndex {
+
+ public:
+  static const int kMaxNeighbours = 8;
+
+  // The deck must be fully loaded; pairs added to it later have no neighbours
+  explicit SimilarityIndex(Deck *deck);
+
+  // Appends the pair's neighbours, closest first
+  void GetNeighbours(int pair_index, std::vector<int> *neighbours);
+  std::size_t GetMemoryBytes();
+
+ private:
+  // Neighbours of pair i are at [neighbour_offsets_[i], neighbour_offsets_[i + 1]) in neighbours_
+  std::vector<int> neighbour_offsets_;
+  std::vector<int> neighbours_;
+
+};
+
+}
+
+#endif //CROSSLANGUAGEMATCH_INCLUDE_DECK_SIMILARITY_INDEX_H_
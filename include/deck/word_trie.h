@@ -0,0 +1,62 @@
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "deck/deck.h"
+
+#ifndef CROSSLANGUAGEMATCH_INCLUDE_DECK_WORD_TRIE_H_
+#define CROSSLANGUAGEMATCH_INCLUDE_DECK_WORD_TRIE_H_
+
+namespace cross_language_match {
+
+// The distinct right words of a deck, sorted and packed, under a radix trie for completing typed answers.
+//
+// Nodes are laid out breadth first in flat arrays, so the children of a node are contiguous and sorted by the first
+// byte of their labels; a label is a range of the packed words rather than a copy. Because the words are sorted, the
+// words under a node are a contiguous range of them, so listing completions is a slice rather than a walk. Typing
+// moves a Position one byte at a time, and neither that nor listing completions allocates.
+class WordTrie {
+
+ public:
+  // A point in the trie after some prefix: a node, and how many bytes of its label have been matched
+  struct Position {
+    uint32_t node;
+    uint32_t label_bytes_matched;
+  };
+
+  explicit WordTrie(Deck *deck);
+
+  static Position GetRootPosition();
+  // Moves past one more byte of the prefix; returns false, leaving the position as it was, if no word continues so
+  bool Advance(Position *position, char character);
+  int GetCompletionCount(const Position &position);
+  // Writes up to max_count indices of words starting with the prefix, in lexicographic order
+  int GetCompletions(const Position &position, int max_count, int *word_indices);
+
+  int GetWordCount();
+  const char *GetWord(int word_index);
+  // Visits every word, so it is meant for setting up rather than for each keystroke
+  int GetMaxWordLength();
+  std::size_t GetMemoryBytes();
+
+ private:
+  uint32_t GetWordLength(uint32_t word_index);
+
+  // Word i is NUL-terminated at word_offsets_[i]; word_offsets_ ends with the buffer's size
+  std::vector<char> characters_;
+  std::vector<uint32_t> word_offsets_;
+
+  // Node i is labelled with label_lengths_[i] bytes of characters_ from label_offsets_[i]; its children are
+  // [first_children_[i], first_children_[i] + child_counts_[i]), and the words under it are
+  // [first_words_[i], end_words_[i]). Node 0 is the root, with an empty label.
+  std::vector<uint32_t> label_offsets_;
+  std::vector<uint16_t> label_lengths_;
+  std::vector<uint16_t> child_counts_;
+  std::vector<uint32_t> first_children_;
+  std::vector<uint32_t> first_words_;
+  std::vector<uint32_t> end_words_;
+
+};
+
+}
+
+#endif //CROSSLANGUAGEMATCH_INCLUDE_DECK_WORD_TRIE_H_
@@ -3,6 +3,8 @@
 #include <vector>
 #include <string>
 #include <map>
+#include "asset/asset_bundle.h"
+#include "text/font_cache.h"
 #include "text/interactive_text.h"
 
 #ifndef CROSSLANGUAGEMATCH_INCLUDE_GAME_H_
@@ -18,10 +20,13 @@ class Game {
   void Run();
 
  private:
-  const int screen_width_ = 1280;
-  const int screen_height_ = 720;
+  // The window opens at this size, in window coordinates, and scenes follow it as it is resized
+  const int initial_screen_width_ = 1280;
+  const int initial_screen_height_ = 720;
   SDL_Window *window_ = nullptr;
   SDL_Renderer *renderer_ = nullptr;
+  AssetBundle *asset_bundle_ = nullptr;
+  FontCache *font_cache_ = nullptr;
   bool global_quit_ = false;
 
 };
@@ -0,0 +1,17 @@
+#include <cstddef>
+#include <cstdint>
+
+#ifndef CROSSLANGUAGEMATCH_INCLUDE_HASH_FNV1A_H_
+#define CROSSLANGUAGEMATCH_INCLUDE_HASH_FNV1A_H_
+
+namespace cross_language_match {
+
+static const uint64_t kFnv1a64OffsetBasis = 0xCBF29CE484222325ULL;
+
+// 64-bit FNV-1a; cheap for the short strings it is used on, such as identifying a word pair across sessions. Pass
+// the previous result as the basis to hash several buffers as one.
+uint64_t Fnv1a64(const void *data, std::size_t length, uint64_t basis = kFnv1a64OffsetBasis);
+
+}
+
+#endif //CROSSLANGUAGEMATCH_INCLUDE_HASH_FNV1A_H_
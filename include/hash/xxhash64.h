@@ -0,0 +1,35 @@
+#include <cstddef>
+#include <cstdint>
+
+#ifndef CROSSLANGUAGEMATCH_INCLUDE_HASH_XXHASH64_H_
+#define CROSSLANGUAGEMATCH_INCLUDE_HASH_XXHASH64_H_
+
+namespace cross_language_match {
+
+// XXH64, compatible with the reference xxHash implementation. It consumes 32 bytes per step, so unlike Fnv1a64 it
+// stays cheap on whole files, such as identifying an uploaded deck by its bytes.
+uint64_t XxHash64(const void *data, std::size_t length, uint64_t seed = 0);
+
+// The same hash over input that arrives in pieces, such as a file read in chunks. Any split of the input into Update
+// calls gives the same Digest as XxHash64 over the whole of it.
+class XxHash64State {
+ public:
+  explicit XxHash64State(uint64_t seed = 0);
+  void Update(const void *data, std::size_t length);
+  uint64_t Digest() const;
+
+ private:
+  uint64_t seed_;
+  uint64_t accumulator_1_;
+  uint64_t accumulator_2_;
+  uint64_t accumulator_3_;
+  uint64_t accumulator_4_;
+  uint64_t total_length_ = 0;
+  // Input not yet consumed by a 32 byte step
+  unsigned char pending_[32];
+  std::size_t pending_length_ = 0;
+};
+
+}
+
+#endif //CROSSLANGUAGEMATCH_INCLUDE_HASH_XXHASH64_H_
@@ -0,0 +1,70 @@
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+#ifndef CROSSLANGUAGEMATCH_INCLUDE_MEMORY_ROUND_ARENA_H_
+#define CROSSLANGUAGEMATCH_INCLUDE_MEMORY_ROUND_ARENA_H_
+
+namespace cross_language_match {
+
+// Bump allocator for objects that live exactly as long as one round. Objects are destroyed together, in reverse
+// creation order, by a single Release call; the underlying blocks are kept for the next round, so once the arena has
+// grown to fit a round, later rounds of the same size need no new blocks. Memory the objects allocate for themselves,
+// such as string contents, still comes from the general heap.
+class RoundArena {
+
+ public:
+  explicit RoundArena(std::size_t block_size = 64 * 1024);
+  ~RoundArena();
+  RoundArena(const RoundArena &) = delete;
+  RoundArena &operator=(const RoundArena &) = delete;
+
+  template<typename T, typename... Args>
+  T *Create(Args &&... args) {
+    void *memory = Allocate(sizeof(T), alignof(T));
+    T *object = new(memory) T(std::forward<Args>(args)...);
+    destructors_.push_back({&Destroy<T>, object});
+    allocation_count_++;
+    return object;
+  }
+
+  void Release();
+  int GetAllocationCount();
+  // Blocks the arena had to add, rather than every heap allocation made while the objects were built
+  int GetNewBlockCount();
+
+ private:
+
+  struct Block {
+    char *memory;
+    std::size_t size;
+  };
+
+  struct Destructor {
+    void (*destroy)(void *);
+    void *object;
+  };
+
+  template<typename T>
+  static void Destroy(void *object) {
+    static_cast<T *>(object)->~T();
+  }
+
+  void *Allocate(std::size_t size, std::size_t alignment);
+
+  const std::size_t block_size_;
+  std::vector<Block> blocks_;
+  std::size_t current_block_ = 0;
+  std::size_t current_offset_ = 0;
+  std::vector<Destructor> destructors_;
+
+  // Both counters cover the period since the last Release
+  int allocation_count_ = 0;
+  int new_block_count_ = 0;
+
+};
+
+}
+
+#endif //CROSSLANGUAGEMATCH_INCLUDE_MEMORY_ROUND_ARENA_H_
@@ -1,9 +1,19 @@
+#include <chrono>
 #include <string>
 #include <map>
+#include <vector>
 #include <SDL_ttf.h>
 #include "button/rectangular_button.h"
 #include "button/button_event.h"
 #include "scene.h"
+#include "board/match_board.h"
+#include "deck/deck.h"
+#include "deck/deck_watcher.h"
+#include "deck/leitner_scheduler.h"
+#include "deck/similarity_index.h"
+#include "memory/round_arena.h"
+#include "stats/attempt_log.h"
+#include "storage/session_snapshot.h"
 #include "text/interactive_text.h"
 
 #ifndef CROSSLANGUAGEMATCH_INCLUDE_GAME_SCENE_H_
@@ -14,29 +24,76 @@ namespace cross_language_match {
 class GameScene : public Scene {
 
  public:
+  // Takes ownership of the deck
   GameScene(SDL_Renderer *renderer,
             SDL_Window *window,
             bool &global_quit,
-            int screen_height,
-            int screen_width,
-            std::map<std::string, std::string> word_pairs);
+            FontCache *font_cache,
+            Deck *deck);
   ~GameScene();
 
+  // Starts the game from scratch, replacing any saved session. The scene may already have been prepared, so the saved
+  // session is only replaced once its first frame is on screen.
+  void StartNewSession();
+  // Continues the game saved in the session snapshot, which must be for this scene's deck; returns false if the
+  // snapshot cannot be used, in which case the scene should be discarded
+  bool RestoreSession();
+  // Follows edits to the word file the deck was built from, applying them to the game in progress; only for fully
+  // loaded decks from plain files. Returns whether the file is followed; paged decks read the file as it is, so it must
+  // then be left alone.
+  bool WatchDeckFile(const std::string &file_path);
+  // Takes ownership of the index, which must be for this scene's deck; rounds then group words that are spelled alike
+  void SetSimilarityIndex(SimilarityIndex *similarity_index);
+  // Rounds then hold more pairs than fit on screen, shown in columns that scroll; call before the scene is prepared
+  void UseLongRounds();
+
+  const char *GetSceneName() override;
   void RunPreLoop() override;
   void RunPostLoop() override;
   void RunSingleIterationEventHandler(SDL_Event &event) override;
   void RunSingleIterationLoopBody() override;
+  void RunLayout() override;
+  bool IsAnimating() override;
 
  private:
   void PrepareCurrentWords();
+  void BuildCurrentWords();
+  void PositionCurrentWords();
+  void PositionScrollingColumns();
+  void ScrollColumn(InteractiveTextGroup column, int delta);
+  void BindVisibleRows(InteractiveTextGroup column);
+  void BindRow(InteractiveTextGroup column, int row);
+  void UnbindRow(InteractiveTextGroup column, int row);
+  const char *GetRowWord(InteractiveTextGroup column, int row);
+  std::vector<InteractiveText *> &GetColumnWords(InteractiveTextGroup column);
+  bool IsMouseInColumnViewport();
+  void RenderScrollingColumns();
+  InteractiveText *FindWordUnderMouse();
+  void HandleDragEvent(SDL_Event &event);
+  void EndDrag();
+  void RenderScene();
+  void RenderDragFrame();
+  void UpdateStaticLayer();
+  void RestoreCurrentLinks();
   void CleanCurrentWords();
-  bool AreAllWordsLinkedAndCorrect(std::vector<InteractiveText *> *all_words,
-                                   std::map<std::string, std::string> *expected_word_pairs);
-  void Shuffle(std::vector<InteractiveText *> *vector);
-  std::vector<InteractiveText *> *GetUnifiedVector(std::vector<InteractiveText *> *a,
-                                                   std::vector<InteractiveText *> *b);
-
-  TTF_Font *font_ = nullptr;
+  bool AreAllWordsLinkedAndCorrect();
+  void UpdateProgressText();
+  void PositionProgressText();
+  void CountRoundErrors();
+  void RecordRoundResults();
+  void LoadAttemptHistory();
+  void UpdateLinkTimes();
+  void AppendSubmittedAttempts();
+  bool IsRestoredRoundValid();
+  void WriteNewSession();
+  void SaveSessionState();
+  void SaveSessionRound();
+  void ApplyDeckEdit();
+  void ReplaceRightWord(int round_pair);
+
+  SdfFont *font_ = nullptr;
+  // Covers the characters of the deck, which the font for the scene's own strings may not
+  FontChain *word_font_chain_ = nullptr;
   SDL_Color plain_text_color_ = {0xFF, 0xFF, 0xFF};
   SDL_Color button_text_color_ = {0, 0, 0};
   SDL_Color interactive_text_color_ = {0xFF, 0xFF, 0xFF};
@@ -44,6 +101,11 @@ class GameScene : public Scene {
   Text *incorrect_text_ = nullptr;
   Text *correct_text_ = nullptr;
 
+  // Re-rendered only when the board's correct count changes
+  Text *progress_text_ = nullptr;
+  int progress_text_correct_count_ = -1;
+  int progress_text_pair_count_ = -1;
+
   Text *submit_text_ = nullptr;
   RectangularButton *submit_button_ = nullptr;
   Text *next_round_text_ = nullptr;
@@ -55,26 +117,93 @@ class GameScene : public Scene {
   ButtonEvent next_round_button_event_ = NONE;
   ButtonEvent return_button_event_ = NONE;
 
-  std::vector<InteractiveText *> *left_words_ = nullptr;
-  std::vector<InteractiveText *> *right_words_ = nullptr;
-  std::vector<InteractiveText *> *left_and_right_words_ = nullptr;
-  std::map<std::string, std::string> *remaining_word_pairs_ = nullptr;
-  std::map<std::string, std::string> *current_word_pairs_ = nullptr;
+  // Round widgets live in the arena; the containers below are cleared, not freed, between rounds so that they keep
+  // their capacity
+  RoundArena round_arena_;
+  std::vector<InteractiveText *> left_words_;
+  std::vector<InteractiveText *> right_words_;
+  // Indexed by board slot
+  std::vector<InteractiveText *> left_and_right_words_;
+  MatchBoard board_;
+  Deck *deck_ = nullptr;
+  DeckWatcher *deck_watcher_ = nullptr;
+  DeckEdit deck_edit_;
+  LeitnerScheduler *scheduler_ = nullptr;
+  SimilarityIndex *similarity_index_ = nullptr;
+  std::vector<int> current_pair_indices_;
+  // Wrong links seen at submission, per pair of the current round
+  std::vector<int> round_error_counts_;
+  bool round_results_recorded_ = false;
+  // Order in which the current pairs appear in the right column
+  std::vector<int> right_order_;
+
+  bool long_rounds_ = false;
+  // A round with more pairs than fit on screen is shown in columns that scroll separately. Every slot has its word, but
+  // only rows in view have a text: a row leaving the view gives its text back to the pool, and rows coming into view
+  // take theirs from it, so that neither drawing nor scrolling costs more for a longer round, and the arena stops
+  // growing once the pool holds a screenful of texts.
+  bool scrolling_columns_ = false;
+  SDL_Rect column_viewport_ = {0, 0, 0, 0};
+  int row_pitch_ = 0;
+  int scroll_offsets_[2] = {0, 0};
+  // Rows [first, end) of each column that have a text
+  int first_bound_rows_[2] = {0, 0};
+  int bound_row_ends_[2] = {0, 0};
+  std::vector<Text *> free_texts_;
+  int bound_row_count_ = 0;
+  int created_text_count_ = 0;
+
+  // A link can also be dragged out of a highlighted word and dropped on a word of the other column. While it is, the
+  // scene is drawn every display frame, from a copy of everything but the line, made when the drag starts and again
+  // only after events other than mouse motion.
+  int drag_source_slot_ = MatchBoard::kNoSlot;
+  SDL_Texture *static_layer_ = nullptr;
+  int static_layer_width_ = 0;
+  int static_layer_height_ = 0;
+  bool static_layer_is_current_ = false;
+  int drag_frame_count_ = 0;
+  int static_layer_update_count_ = 0;
+  double total_drag_frame_ms_ = 0;
+  double max_drag_frame_ms_ = 0;
+  std::chrono::steady_clock::time_point drag_start_time_;
+
+  AttemptLog *attempt_log_ = nullptr;
+  // Sorted by pair key; consulted by the scheduler as pairs are first drawn
+  std::vector<PairStats> attempt_history_;
+  Uint32 round_start_ticks_ = 0;
+  // Milliseconds from the start of the round until each left slot got its current link; zero while unlinked
+  std::vector<Uint32> round_link_times_ms_;
+  int observed_linked_pair_count_ = 0;
+
+  SessionSnapshot session_snapshot_;
+  // Nothing is saved until the scene is started or restored, so a scene prepared ahead of time and never shown leaves
+  // the saved session alone
+  bool session_is_active_ = false;
+  bool new_session_is_pending_ = false;
+  bool first_frame_presented_ = false;
+  // The round file is rewritten at most once per frame, after input that may have changed the links
+  bool session_round_dirty_ = false;
+  double max_session_round_write_ms_ = 0;
+  RoundSnapshot restored_round_;
+  bool has_restored_round_ = false;
 
   bool all_rounds_complete_ = false;
   bool current_round_is_complete_ = false;
   bool last_submission_was_incorrect_ = false;
 
-  const int screen_height_;
-  const int screen_width_;
   const double screen_height_percentage_reserved_for_words_ = 0.6;
   const int padding_word_columns_ = 100;
   const int font_size_ = 28;
   const int padding_individual_words_ = 15;
   const int button_width_ = 200;
   const int button_height_ = 100;
+  const int long_round_pair_count_ = 100;
+  // Scrolling columns face each other across the gap, where the links are drawn
+  const int scrolling_column_gap_ = 240;
+  const int rows_per_wheel_step_ = 3;
 
-  // Words to be presented per round should be a function of the screen height
+  // Words to be presented per round should be a function of the screen height; it is taken once, when the scene is
+  // created, so resizing the window moves the words of a round but never changes how many there are
   const int words_to_present_per_round_ = (int) (screen_height_ * screen_height_percentage_reserved_for_words_)
       / (font_size_ + InteractiveText::GetPaddingPerSide() * 2 + padding_individual_words_);
 
@@ -13,22 +13,28 @@ namespace cross_language_match {
 class HelpScene : public Scene {
 
  public:
-  HelpScene(SDL_Renderer *renderer, SDL_Window *window, bool &global_quit, int screen_height, int screen_width);
-  ~HelpScene();
+  HelpScene(SDL_Renderer *renderer,
+            SDL_Window *window,
+            bool &global_quit,
+            FontCache *font_cache);
+  const char *GetSceneName() override;
   void RunPreLoop() override;
   void RunPostLoop() override;
   void RunSingleIterationEventHandler(SDL_Event &event) override;
   void RunSingleIterationLoopBody() override;
+  void RunOnEnter() override;
+  bool IsReusable() override;
+  void RunLayout() override;
 
  private:
 
-  TTF_Font *explanation_font_ = nullptr;
+  SdfFont *explanation_font_ = nullptr;
   Text *explanation_text_ = nullptr;
   const int explanation_font_size_ = 22;
   SDL_Color explanation_text_color_ = {0xFF, 0xFF, 0xFF};
 
   Text *return_text_ = nullptr;
-  TTF_Font *return_button_font_ = nullptr;
+  SdfFont *return_button_font_ = nullptr;
   SDL_Color return_text_color_ = {0, 0, 0};
 
   RectangularButton *return_button_ = nullptr;
@@ -38,8 +44,6 @@ class HelpScene : public Scene {
   const int button_height_ = 100;
   const int button_font_size_ = 28;
 
-  const int screen_height_;
-  const int screen_width_;
 
 };
 
@@ -1,9 +1,15 @@
 #include <SDL2/SDL.h>
 #include <SDL_ttf.h>
+#include "deck/deck.h"
+#include "deck/deck_cache.h"
+#include "deck/similarity_index.h"
+#include "deck/word_trie.h"
 #include "word_loader/file_word_loader.h"
 #include "text/text.h"
+#include "button/labeled_button.h"
 #include "button/rectangular_button.h"
 #include "button/button_event.h"
+#include "scene/game_scene.h"
 #include "scene/scene.h"
 
 #ifndef CROSSLANGUAGEMATCH_INCLUDE_SCENE_LOAD_SCENE_H_
@@ -19,19 +25,32 @@ class LoadScene : public Scene {
   LoadScene(SDL_Renderer *renderer,
             SDL_Window *window,
             bool &global_quit,
-            int screen_height,
-            int screen_width
-  );
-  ~LoadScene();
+            FontCache *font_cache);
+  const char *GetSceneName() override;
   void RunPreLoop() override;
   void RunPostLoop() override;
   void RunSingleIterationEventHandler(SDL_Event &event) override;
   void RunSingleIterationLoopBody() override;
+  void RunOnEnter() override;
+  void RunOnResume() override;
+  bool IsReusable() override;
+  void RunLayout() override;
 
  private:
 
   void HandleBeginEvent(SDL_Event &event);
+  GameScene *CreateGameScene();
+  void PrewarmGame();
+  void DiscardPrewarmedGame();
+  void LoadDeck();
+  void ClearLoadedFile();
+  void BuildSimilarityIndex();
+  void BuildWordTrie();
+  void CheckGlyphCoverage();
+  void ShowInputError(WordLoader::InputError input_error);
   void SetErrorMessage(std::string error_message);
+  void SetWarningMessage(std::string warning_message);
+  void PositionMessage();
   void ClearErrorMessage();
   bool IsErrorMessageSet();
   bool IsFileLoaded();
@@ -40,8 +59,10 @@ class LoadScene : public Scene {
 
   Text *explanation_text_ = nullptr;
   Text *error_text_ = nullptr;
+  // Shown in place of an error, but does not keep the game from starting
+  Text *warning_text_ = nullptr;
 
-  TTF_Font *small_font_ = nullptr;
+  SdfFont *small_font_ = nullptr;
   const int small_font_size_ = 22;
   SDL_Color small_font_color_ = {0xFF, 0xFF, 0xFF};
 
@@ -53,11 +74,30 @@ class LoadScene : public Scene {
   RectangularButton *begin_button_ = nullptr;
   ButtonEvent begin_button_event_ = NONE;
 
+  // The button shows whichever label matches the setting
+  Text *hard_rounds_off_text_ = nullptr;
+  Text *hard_rounds_on_text_ = nullptr;
+  LabeledButton *hard_rounds_button_ = nullptr;
+  ButtonEvent hard_rounds_button_event_ = NONE;
+  bool hard_rounds_ = false;
+
+  Text *long_rounds_off_text_ = nullptr;
+  Text *long_rounds_on_text_ = nullptr;
+  LabeledButton *long_rounds_button_ = nullptr;
+  ButtonEvent long_rounds_button_event_ = NONE;
+  bool long_rounds_ = false;
+
+  Text *typed_answers_off_text_ = nullptr;
+  Text *typed_answers_on_text_ = nullptr;
+  LabeledButton *typed_answers_button_ = nullptr;
+  ButtonEvent typed_answers_button_event_ = NONE;
+  bool typed_answers_ = false;
+
   Text *return_button_text_ = nullptr;
   RectangularButton *return_button_ = nullptr;
   ButtonEvent return_button_event_ = NONE;
 
-  TTF_Font *button_font_ = nullptr;
+  SdfFont *button_font_ = nullptr;
   SDL_Color button_text_color_ = {0, 0, 0};
 
   const int wide_button_width_ = 400;
@@ -67,12 +107,25 @@ class LoadScene : public Scene {
   const int return_button_width_ = 200;
   const int return_button_height_ = 100;
 
-  const int screen_height_;
-  const int screen_width_;
 
   char *loaded_file_name_ = nullptr;
   bool loaded_file_has_been_processed_ = false;
-  FileWordLoader *word_loader_;
+  // Set while a game started from this scene is running; the scene leaves as soon as the game does
+  bool game_has_started_ = false;
+  FileWordLoader *word_loader_ = nullptr;
+  // Owned until handed to the game scene
+  Deck *deck_ = nullptr;
+  // While Begin waits to be clicked, a game scene with its first round already built is held by the scene manager;
+  // it owns the deck and the similarity index from then on
+  bool game_is_prewarmed_ = false;
+  // Whether the last game scene created follows edits to the word file
+  bool deck_file_is_watched_ = false;
+  bool begin_button_presented_ = false;
+  // Built for the loaded deck while hard rounds are on; owned until handed to the game scene
+  SimilarityIndex *similarity_index_ = nullptr;
+  // Built for the loaded deck while typed answers are on; owned until handed to the typed game scene
+  WordTrie *word_trie_ = nullptr;
+  DeckCache deck_cache_;
 
 };
 
@@ -1,16 +1,28 @@
 #include <SDL2/SDL.h>
+#include <vector>
+#include "text/font_cache.h"
 
 #ifndef CROSSLANGUAGEMATCH_INCLUDE_SCENE_H_
 #define CROSSLANGUAGEMATCH_INCLUDE_SCENE_H_
 
 namespace cross_language_match {
 
+class SceneManager;
+
+// A screen of the game, run by the scene manager one iteration at a time while it is on top of the stack.
+// RunPreLoop builds the scene's resources once, before it is first shown, and RunPostLoop frees them when the scene
+// is discarded; a scene covered by another keeps its resources until it is shown again.
 class Scene {
 
  public:
-  Scene(SDL_Renderer *renderer, SDL_Window *window, bool &global_quit);
-  ~Scene();
-  void Run();
+  Scene(SDL_Renderer *renderer, SDL_Window *window, bool &global_quit, FontCache *font_cache);
+  virtual ~Scene();
+  long GetRawEventCount();
+  long GetDispatchedEventCount();
+  virtual const char *GetSceneName() = 0;
+  // Scales the renderer from window coordinates, which scenes lay out and receive mouse events in, to the pixels of
+  // the window, which are denser on high density displays
+  static void UpdatePixelScale(SDL_Renderer *renderer, SDL_Window *window);
 
  protected:
 
@@ -18,6 +30,18 @@ class Scene {
   virtual void RunPostLoop() = 0;
   virtual void RunSingleIterationEventHandler(SDL_Event &event) = 0;
   virtual void RunSingleIterationLoopBody() = 0;
+  // Each time the scene is pushed, whether new, preloaded or entered before
+  virtual void RunOnEnter() {}
+  // Each time the scene above it leaves
+  virtual void RunOnResume() {}
+  // A reusable scene is kept, resources and all, when it is left, so that entering it again costs nothing
+  virtual bool IsReusable() { return false; }
+  // While true, the scene is run at the display's refresh rate rather than every 100 ms
+  virtual bool IsAnimating() { return false; }
+  // Positions the scene's contents for the current screen size. Runs after RunPreLoop, before the scene first handles
+  // events, and again whenever the window has been resized since; only positions change, nothing is rebuilt.
+  virtual void RunLayout() {}
+  // Leaves the scene once the current event has been handled
   void QuitLocal();
   void QuitGlobal();
 
@@ -25,9 +49,32 @@ class Scene {
   SDL_Window *window_;
   bool &global_quit_;
   bool local_quit_;
+  // Shared by every scene, which takes its fonts from it rather than opening its own
+  FontCache *font_cache_;
+  // Set by the manager when the scene is pushed or preloaded
+  SceneManager *scene_manager_ = nullptr;
 
   SDL_Color background_color_ = {0xFF, 0x7F, 0x50, 0xFF};
 
+  // Size of the window in window coordinates, as of the last layout, or of construction before the first
+  int screen_width_ = 0;
+  int screen_height_ = 0;
+
+ private:
+  friend class SceneManager;
+
+  // Dispatches pending events until one of them leaves the scene or pushes another, then draws a frame unless one did;
+  // returns whether a frame was drawn
+  bool RunSingleIteration();
+  void CollectPendingEvents();
+  void UpdateLayout();
+
+  std::vector<SDL_Event> pending_events_;
+  long raw_event_count_ = 0;
+  long dispatched_event_count_ = 0;
+  bool prepared_ = false;
+  bool laid_out_ = false;
+
 };
 
 }
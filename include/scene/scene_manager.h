@@ -0,0 +1,81 @@
+#include <chrono>
+#include <string>
+#include <vector>
+#include "scene/scene.h"
+
+#ifndef CROSSLANGUAGEMATCH_INCLUDE_SCENE_SCENE_MANAGER_H_
+#define CROSSLANGUAGEMATCH_INCLUDE_SCENE_SCENE_MANAGER_H_
+
+namespace cross_language_match {
+
+// Runs the scene on top of a stack of live scenes. Pushing a scene covers the current one without tearing it down, and
+// a scene that quits uncovers the one below exactly as it was left, so going back costs no rebuilding at all.
+//
+// Scenes likely to be entered next can be preloaded: they are prepared ahead of time and held until taken. Reusable
+// scenes are held the same way when they are left, so entering them again is as cheap as going back. Every
+// transition is timed from the event that asked for it to the first frame of the scene it leads to, and the very first
+// frame also from the moment the page began loading.
+class SceneManager {
+
+ public:
+  explicit SceneManager(bool &global_quit);
+  ~SceneManager();
+
+  SceneManager(const SceneManager &) = delete;
+  SceneManager &operator=(const SceneManager &) = delete;
+
+  // Takes ownership; the scene is shown once the current event has been handled. One scene can be pushed per event.
+  void Push(Scene *scene);
+  bool HasPendingScene();
+  // Takes ownership of a scene that is likely to be pushed soon, and prepares it now
+  void Preload(Scene *scene);
+  // Gives back a preloaded or previously left reusable scene of the given type, or nullptr if none is held
+  template<typename T>
+  T *TakeHeldScene() {
+    for (auto scene = held_scenes_.begin(); scene != held_scenes_.end(); scene++) {
+      T *typed_scene = dynamic_cast<T *>(*scene);
+      if (typed_scene != nullptr) {
+        held_scenes_.erase(scene);
+        return typed_scene;
+      }
+    }
+    return nullptr;
+  }
+  template<typename T>
+  bool IsHoldingScene() {
+    for (Scene *scene : held_scenes_) {
+      if (dynamic_cast<T *>(scene) != nullptr) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Runs until the last scene quits or the game is quit
+  void Run();
+
+ private:
+  bool ApplyTransitions();
+  void Prepare(Scene *scene);
+  void Discard(Scene *scene);
+  void StartTransitionTiming();
+  void ReportTransitionTiming();
+
+  bool &global_quit_;
+  std::vector<Scene *> scenes_;
+  Scene *pending_scene_ = nullptr;
+  // Preloaded scenes and reusable scenes that were left, ready to be taken
+  std::vector<Scene *> held_scenes_;
+
+  bool first_frame_reported_ = false;
+  bool transition_is_timed_ = false;
+  std::chrono::steady_clock::time_point transition_start_time_;
+  std::string transition_from_;
+  // Time spent preparing scenes that were pushed without having been preloaded
+  double transition_preparation_ms_ = 0;
+
+};
+
+}
+
+#endif //CROSSLANGUAGEMATCH_INCLUDE_SCENE_SCENE_MANAGER_H_
@@ -13,21 +13,28 @@ namespace cross_language_match {
 class StartScene : public Scene {
 
  public:
-  StartScene(SDL_Renderer *renderer, SDL_Window *window, bool &global_quit, int screen_height, int screen_width);
-  ~StartScene();
+  StartScene(SDL_Renderer *renderer,
+             SDL_Window *window,
+             bool &global_quit,
+             FontCache *font_cache);
+  const char *GetSceneName() override;
   void RunPreLoop() override;
   void RunPostLoop() override;
   void RunSingleIterationEventHandler(SDL_Event &event) override;
   void RunSingleIterationLoopBody() override;
+  void RunOnResume() override;
+  void RunLayout() override;
 
  private:
+  void ResumeSession();
+  void PreloadNextScenes();
 
-  TTF_Font *title_font_ = nullptr;
+  SdfFont *title_font_ = nullptr;
   Text *title_text_ = nullptr;
   const int title_font_size_ = 44;
   SDL_Color title_text_color_ = {0xFF, 0xFF, 0xFF};
 
-  TTF_Font *button_font_ = nullptr;
+  SdfFont *button_font_ = nullptr;
   const int button_font_size_ = 28;
 
   Text *start_text_ = nullptr;
@@ -43,8 +50,15 @@ class StartScene : public Scene {
   RectangularButton *help_button_ = nullptr;
   ButtonEvent help_button_event_ = NONE;
 
-  const int screen_height_;
-  const int screen_width_;
+  // Only shown when a game in progress was saved
+  Text *resume_text_ = nullptr;
+  RectangularButton *resume_button_ = nullptr;
+  ButtonEvent resume_button_event_ = NONE;
+  bool session_can_be_resumed_ = false;
+
+  // The help and load scenes are prepared once the menu is up, so that opening either shows its first frame at once
+  bool first_frame_presented_ = false;
+
 
 };
 
@@ -0,0 +1,135 @@
+#include <chrono>
+#include <string>
+#include <vector>
+#include <SDL_ttf.h>
+#include "button/button_event.h"
+#include "button/labeled_button.h"
+#include "scene.h"
+#include "deck/deck.h"
+#include "deck/leitner_scheduler.h"
+#include "deck/similarity_index.h"
+#include "deck/word_trie.h"
+#include "stats/attempt_log.h"
+#include "text/text.h"
+
+#ifndef CROSSLANGUAGEMATCH_INCLUDE_SCENE_TYPED_GAME_SCENE_H_
+#define CROSSLANGUAGEMATCH_INCLUDE_SCENE_TYPED_GAME_SCENE_H_
+
+namespace cross_language_match {
+
+// The game played by typing: the left words of a round are shown one at a time, and each must be answered with its
+// right word. As the answer is typed, the right words of the deck starting with it are offered below; Tab takes the
+// first of them and Enter submits.
+//
+// The typed prefix is followed through a word trie one byte at a time, with the trie position after each byte kept on
+// a stack, so that a keystroke or a backspace costs one trie step and no allocation however large the deck. The answer
+// line is still rasterized again on each keystroke, into the one Text kept for it.
+class TypedGameScene : public Scene {
+
+ public:
+  static const int kSuggestionCount = 5;
+  // Answers may always run to this many bytes, and further when the deck has longer right words
+  static const int kMinAnswerCapacityBytes = 256;
+
+  // Takes ownership of the deck and of the trie, which must have been built from the deck
+  TypedGameScene(SDL_Renderer *renderer,
+                 SDL_Window *window,
+                 bool &global_quit,
+                 FontCache *font_cache,
+                 Deck *deck,
+                 WordTrie *word_trie);
+  ~TypedGameScene();
+
+  // Takes ownership of the index, which must be for this scene's deck
+  void SetSimilarityIndex(SimilarityIndex *similarity_index);
+
+  const char *GetSceneName() override;
+  void RunPreLoop() override;
+  void RunPostLoop() override;
+  void RunSingleIterationEventHandler(SDL_Event &event) override;
+  void RunSingleIterationLoopBody() override;
+  void RunLayout() override;
+
+ private:
+  void PrepareRound();
+  void ShowPrompt();
+  void PositionPromptLines();
+  void AppendAnswerBytes(const char *bytes);
+  void RemoveAnswerCharacter();
+  void AcceptFirstSuggestion();
+  void ClearAnswer();
+  void FinishKeystroke(std::chrono::steady_clock::time_point start_time);
+  bool FindSuggestions();
+  void RenderSuggestions();
+  void UpdateAnswerText();
+  void SubmitAnswer();
+  void UpdateProgressText();
+  void PositionProgressText();
+  void RecordRoundResults();
+  void LoadAttemptHistory();
+  void CleanRound();
+
+  SdfFont *font_ = nullptr;
+  // Covers the characters of the deck, which the font for the scene's own strings may not
+  FontChain *word_font_chain_ = nullptr;
+  SDL_Color plain_text_color_ = {0xFF, 0xFF, 0xFF};
+  SDL_Color button_text_color_ = {0, 0, 0};
+  SDL_Color suggestion_text_color_ = {0xFF, 0xE4, 0xC4};
+
+  Text *prompt_text_ = nullptr;
+  Text *answer_text_ = nullptr;
+  Text *hint_text_ = nullptr;
+  Text *progress_text_ = nullptr;
+  Text *incorrect_text_ = nullptr;
+  Text *correct_text_ = nullptr;
+  Text *suggestion_texts_[kSuggestionCount] = {nullptr};
+
+  Text *next_round_text_ = nullptr;
+  LabeledButton *next_round_button_ = nullptr;
+  Text *return_text_ = nullptr;
+  LabeledButton *return_button_ = nullptr;
+  ButtonEvent next_round_button_event_ = NONE;
+  ButtonEvent return_button_event_ = NONE;
+
+  Deck *deck_ = nullptr;
+  WordTrie *word_trie_ = nullptr;
+  SimilarityIndex *similarity_index_ = nullptr;
+  LeitnerScheduler *scheduler_ = nullptr;
+  AttemptLog *attempt_log_ = nullptr;
+  // Sorted by pair key; consulted by the scheduler as pairs are first drawn
+  std::vector<PairStats> attempt_history_;
+
+  std::vector<int> current_pair_indices_;
+  // Wrong answers submitted, per pair of the current round
+  std::vector<int> round_error_counts_;
+  // Index into current_pair_indices_ of the pair being asked for
+  int current_prompt_ = 0;
+  Uint32 prompt_start_ticks_ = 0;
+
+  // Capacity for max_answer_bytes_ is reserved up front, so typing never grows either of these. The stack holds the
+  // root followed by the position after each matched byte; bytes typed past the last match are only counted.
+  const int max_answer_bytes_;
+  std::string answer_;
+  std::vector<WordTrie::Position> answer_positions_;
+  int unmatched_byte_count_ = 0;
+
+  // Suggestions are rasterized again only when the words offered change
+  int suggestions_[kSuggestionCount] = {0};
+  int suggestion_count_ = 0;
+  double max_keystroke_us_ = 0;
+
+  bool all_rounds_complete_ = false;
+  bool current_round_is_complete_ = false;
+  bool last_answer_was_incorrect_ = false;
+
+  const int font_size_ = 28;
+  const int padding_lines_ = 15;
+  const int button_width_ = 200;
+  const int button_height_ = 100;
+  const int pairs_per_round_ = 8;
+
+};
+
+}
+
+#endif //CROSSLANGUAGEMATCH_INCLUDE_SCENE_TYPED_GAME_SCENE_H_
@@ -0,0 +1,61 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifndef CROSSLANGUAGEMATCH_INCLUDE_STATS_ATTEMPT_LOG_H_
+#define CROSSLANGUAGEMATCH_INCLUDE_STATS_ATTEMPT_LOG_H_
+
+namespace cross_language_match {
+
+struct AttemptRecord {
+  uint64_t pair_key;
+  uint32_t time_to_link_ms;
+  uint32_t correct;
+};
+
+struct PairStats {
+  uint64_t pair_key;
+  uint32_t attempt_count;
+  uint32_t correct_count;
+  uint64_t total_time_to_link_ms;
+};
+
+// Per-pair answer history, kept as an append-only file of fixed-size binary records next to a snapshot of per-pair
+// totals sorted by pair key. Appends only go to memory; Flush writes them out in one call, and compaction folds the
+// log into the snapshot so that loading stays a couple of bulk reads plus one merge however long the history gets.
+// Both files are plain files in the given directory, which is expected to be persisted by the caller.
+class AttemptLog {
+
+ public:
+  explicit AttemptLog(std::string directory);
+  ~AttemptLog();
+
+  void Append(uint64_t pair_key, bool correct, uint32_t time_to_link_ms);
+  void Flush();
+  void CompactIfNeeded();
+  void Compact();
+
+  // Returns totals per pair, sorted by pair key, including appends that have not been flushed yet
+  std::vector<PairStats> LoadStats();
+  static const PairStats *FindStats(const std::vector<PairStats> &stats, uint64_t pair_key);
+  static uint64_t GetPairKey(const char *left_word, const char *right_word);
+
+ private:
+
+  std::vector<PairStats> ReadSnapshot();
+  std::vector<AttemptRecord> ReadLog();
+  bool WriteSnapshot(const std::vector<PairStats> &stats);
+
+  static const std::size_t kMagicLength = 8;
+  static const long kCompactionThreshold = 16384;
+
+  std::string log_path_;
+  std::string snapshot_path_;
+  std::vector<AttemptRecord> pending_records_;
+  long log_record_count_ = 0;
+
+};
+
+}
+
+#endif //CROSSLANGUAGEMATCH_INCLUDE_STATS_ATTEMPT_LOG_H_
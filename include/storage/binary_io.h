@@ -0,0 +1,42 @@
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#ifndef CROSSLANGUAGEMATCH_INCLUDE_STORAGE_BINARY_IO_H_
+#define CROSSLANGUAGEMATCH_INCLUDE_STORAGE_BINARY_IO_H_
+
+namespace cross_language_match {
+
+// Helpers for the raw binary files this game writes. Values are stored in native byte order; the files are only ever
+// read back by the same build on the same machine.
+
+template<typename T>
+bool WriteValue(FILE *file, const T &value) {
+  return fwrite(&value, sizeof(T), 1, file) == 1;
+}
+
+template<typename T>
+bool ReadValue(FILE *file, T *value) {
+  return fread(value, sizeof(T), 1, file) == 1;
+}
+
+template<typename T>
+bool WriteVector(FILE *file, const std::vector<T> &values) {
+  uint64_t count = values.size();
+  return WriteValue(file, count) && fwrite(values.data(), sizeof(T), values.size(), file) == values.size();
+}
+
+// Refuses vectors longer than max_count, so that a corrupt length cannot trigger a huge allocation
+template<typename T>
+bool ReadVector(FILE *file, std::vector<T> *values, uint64_t max_count) {
+  uint64_t count = 0;
+  if (!ReadValue(file, &count) || count > max_count) {
+    return false;
+  }
+  values->resize(count);
+  return fread(values->data(), sizeof(T), count, file) == count;
+}
+
+}
+
+#endif //CROSSLANGUAGEMATCH_INCLUDE_STORAGE_BINARY_IO_H_
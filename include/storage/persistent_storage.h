@@ -0,0 +1,17 @@
+#ifndef CROSSLANGUAGEMATCH_INCLUDE_STORAGE_PERSISTENT_STORAGE_H_
+#define CROSSLANGUAGEMATCH_INCLUDE_STORAGE_PERSISTENT_STORAGE_H_
+
+namespace cross_language_match {
+
+// Directory whose contents survive page reloads; it is backed by IndexedDB through Emscripten's IDBFS
+static const char *kPersistentStorageDirectory = "/persistent";
+
+// Mounts the persistent directory and waits until its previous contents have been loaded from IndexedDB
+void MountPersistentStorage();
+
+// Starts copying the persistent directory back to IndexedDB; returns immediately and never blocks a frame
+void SyncPersistentStorage();
+
+}
+
+#endif //CROSSLANGUAGEMATCH_INCLUDE_STORAGE_PERSISTENT_STORAGE_H_
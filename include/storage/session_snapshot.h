@@ -0,0 +1,57 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "deck/deck.h"
+#include "deck/leitner_scheduler.h"
+
+#ifndef CROSSLANGUAGEMATCH_INCLUDE_STORAGE_SESSION_SNAPSHOT_H_
+#define CROSSLANGUAGEMATCH_INCLUDE_STORAGE_SESSION_SNAPSHOT_H_
+
+namespace cross_language_match {
+
+// State of the round on screen; links are stored per left slot as the linked right slot, or MatchBoard::kNoSlot
+struct RoundSnapshot {
+  int scheduler_round = 0;
+  std::vector<int> pair_indices;
+  std::vector<int> right_order;
+  std::vector<int> links;
+  std::vector<int> error_counts;
+  bool results_recorded = false;
+  bool round_complete = false;
+};
+
+// Binary snapshot of a game in progress, split across three files so that each is only rewritten when its part
+// changes: the compiled deck once per game, the deck and scheduler state once per round, and the tiny round file on
+// every interaction. Each file is written beside its old version and renamed over it, so a reload mid-write still
+// finds the previous complete snapshot.
+class SessionSnapshot {
+
+ public:
+  explicit SessionSnapshot(std::string directory);
+
+  bool WriteDeck(Deck *deck);
+  bool WriteState(Deck *deck, LeitnerScheduler *scheduler);
+  bool WriteRound(uint64_t deck_content_hash, const RoundSnapshot &round);
+
+  // Loads the compiled deck the saved state refers to, or returns nullptr if there is no usable snapshot
+  Deck *ReadDeck(unsigned int seed);
+  bool ReadState(Deck *deck, LeitnerScheduler *scheduler);
+  bool ReadRound(uint64_t deck_content_hash, RoundSnapshot *round);
+
+  bool Exists();
+  void Clear();
+
+ private:
+
+  bool ReadStateHeader(FILE *file, uint64_t *deck_content_hash);
+  bool ReplaceFile(const std::string &temporary_path, const std::string &path, bool written);
+
+  std::string deck_path_;
+  std::string state_path_;
+  std::string round_path_;
+
+};
+
+}
+
+#endif //CROSSLANGUAGEMATCH_INCLUDE_STORAGE_SESSION_SNAPSHOT_H_
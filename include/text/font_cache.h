@@ -0,0 +1,82 @@
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include <SDL_ttf.h>
+#include "asset/asset_bundle.h"
+#include "deck/deck.h"
+#include "text/font_chain.h"
+#include "text/sdf_atlas.h"
+#include "text/sdf_font.h"
+#include "text/shaped_text_cache.h"
+
+#ifndef CROSSLANGUAGEMATCH_INCLUDE_TEXT_FONT_CACHE_H_
+#define CROSSLANGUAGEMATCH_INCLUDE_TEXT_FONT_CACHE_H_
+
+namespace cross_language_match {
+
+// Fonts shared by every scene, opened from the asset bundle the first time each face and size is asked for. Each font
+// file is fetched once and read in place by every size opened from it.
+//
+// The faces are subsets of the default font, made at build time, followed by fallback fonts for the scripts it lacks.
+// The game's own strings need only the smallest subset, whose glyphs are turned into a distance field atlas once and
+// drawn from it at every size. Words from a deck are drawn through a font chain that starts
+// at the smallest subset covering the deck's characters and falls back, character by character, to the other faces;
+// a face is only fetched once a word needs it, and a fallback font missing from the bundle is skipped.
+class FontCache {
+
+ public:
+  explicit FontCache(AssetBundle *asset_bundle);
+  ~FontCache();
+
+  FontCache(const FontCache &) = delete;
+  FontCache &operator=(const FontCache &) = delete;
+
+  // For the game's own strings. Owned by the cache and valid until it is destroyed; throws if the font cannot be
+  // opened.
+  SdfFont *GetFont(int point_size);
+  // For words from the deck; owned by the cache. A chain taken before the deck's words were noted still draws every
+  // character it can, but may split words into more runs than needed.
+  FontChain *GetWordFontChain(int point_size);
+  // Shared by the word font chains; owned by the font cache
+  ShapedTextCache *GetShapedTextCache();
+
+  // Notes every character of the deck's words, replacing the previous deck's; paged decks are not read through
+  void CoverDeck(Deck *deck);
+  // Characters of the noted words that no bundled font provides, fetching the fallback fonts the words need to check
+  std::vector<uint32_t> FindUnrenderableCodePoints();
+
+  // Used by font chains
+  FontChain *GetFontChain(int first_face, int point_size);
+  bool IsInFace(int face, uint32_t code_point);
+  bool IsRightToLeftFace(int face);
+  // Returns nullptr if the face is a fallback font that is not in the bundle
+  TTF_Font *OpenFace(int face, int point_size);
+
+ private:
+  void CoverWord(const char *word);
+
+  AssetBundle *asset_bundle_;
+  // Keyed by face and point size
+  std::map<std::pair<int, int>, TTF_Font *> fonts_;
+  SdfAtlas *ui_atlas_ = nullptr;
+  // Keyed by point size
+  std::map<int, SdfFont *> ui_fonts_;
+  // Keyed by first face and point size
+  std::map<std::pair<int, int>, FontChain *> word_font_chains_;
+  std::vector<bool> missing_faces_;
+  std::vector<bool> fetched_faces_;
+  std::size_t font_file_bytes_ = 0;
+
+  // One flag per code point, for the characters of the noted words outside the smallest subset
+  std::vector<bool> noted_code_points_;
+  int first_word_face_ = 0;
+
+  ShapedTextCache *shaped_text_cache_;
+
+};
+
+}
+
+#endif //CROSSLANGUAGEMATCH_INCLUDE_TEXT_FONT_CACHE_H_
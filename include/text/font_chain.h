@@ -0,0 +1,51 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <SDL_ttf.h>
+
+#ifndef CROSSLANGUAGEMATCH_INCLUDE_TEXT_FONT_CHAIN_H_
+#define CROSSLANGUAGEMATCH_INCLUDE_TEXT_FONT_CHAIN_H_
+
+namespace cross_language_match {
+
+class FontCache;
+class ShapedTextCache;
+
+// A stretch of a string whose characters are all drawn from the same font
+struct FontRun {
+  TTF_Font *font;
+  std::size_t begin;
+  std::size_t end;
+  bool right_to_left;
+};
+
+// Faces of the font cache at one point size, tried in order for each character. A face is opened the first time a
+// character meant for it is drawn, so a chain covering many scripts costs nothing for the scripts a deck never uses.
+class FontChain {
+
+ public:
+  FontChain(FontCache *font_cache, std::vector<int> faces, int point_size);
+
+  // Splits the text into runs, giving each character to the first face meant for its script that the bundle has, or
+  // to the first face if none is. Combining marks stay with the character before them, as do spaces and punctuation
+  // after a right-to-left run, so that a phrase in such a script is shaped as one run.
+  void Segment(const std::string &text, std::vector<FontRun> *runs);
+  TTF_Font *FindFont(uint32_t code_point);
+  TTF_Font *GetPrimaryFont();
+  // Words of this chain are drawn through it
+  ShapedTextCache *GetShapedTextCache();
+  // The same faces at the point size times the given number of pixels per point; owned by the font cache
+  FontChain *AtPixelScale(float pixel_scale);
+
+ private:
+  int FindFace(uint32_t code_point);
+
+  FontCache *font_cache_;
+  const std::vector<int> faces_;
+  const int point_size_;
+
+};
+
+}
+
+#endif //CROSSLANGUAGEMATCH_INCLUDE_TEXT_FONT_CHAIN_H_
@@ -1,6 +1,8 @@
 #include <SDL2/SDL.h>
 #include <vector>
 #include "text.h"
+#include "text/interactive_text_group.h"
+#include "board/match_board.h"
 #include "button/cancellation_circle_button.h"
 
 #ifndef CROSSLANGUAGEMATCH_INCLUDE_INTERACTIVE_TEXT_H_
@@ -8,38 +10,53 @@
 
 namespace cross_language_match {
 
-enum InteractiveTextGroup {
-  LEFT = 0,
-  RIGHT = 1
-};
-
+// On-screen view of a single MatchBoard slot; link and highlight state live in the board, while this class only holds
+// what is needed to draw and hit-test the word. The views passed to HandleEvent must be indexed by slot.
 class InteractiveText : public Rectangle {
 
  public:
-  InteractiveText(SDL_Renderer *renderer, Text *text, InteractiveTextGroup group);
+  InteractiveText(SDL_Renderer *renderer, Text *text, MatchBoard *board, int slot);
+  // A word whose text is given later, for a row of a scrolling column that is not yet in view. It has no width until
+  // it has a text, and must not be drawn before.
+  InteractiveText(SDL_Renderer *renderer, int height, MatchBoard *board, int slot);
   void AddHighlight();
   void RemoveHighlight();
   void AddLink(InteractiveText *other);
   void RemoveLink();
-  InteractiveText *GetLink();
+  bool IsLinked();
   void Render() override;
+  // Draws only the link, for a left word out of view whose link may still cross the view
+  void RenderLink();
+  // Draws a line from where a link from this word would start to the given point, for a link being dragged out
+  void RenderDragLine(int to_x, int to_y);
   void SetTopLeftPosition(int top_left_x, int top_left_y) override;
-  void HandleEvent(SDL_Event *event, std::vector<InteractiveText *> all_text);
+  // Redraws the link between the word and its partner from where they are now, after either has moved; only the left
+  // word of a link holds its geometry
+  void RebuildLinkGeometry(const std::vector<InteractiveText *> &all_words);
+  void HandleEvent(SDL_Event *event, const std::vector<InteractiveText *> &all_words);
   const Text *GetText();
+  // Resizes the word to fit the new text, keeping its top left corner; the caller owns both texts
+  void SetText(Text *text);
+  // Leaves the word without a text, and without width, returning the text it had
+  Text *ReleaseText();
+  bool HasText();
   InteractiveTextGroup GetGroup();
+  int GetSlot();
   static int GetPaddingPerSide();
 
  private:
 
+  void BuildLinkGeometry(InteractiveText *right_interactive_text);
+
   static const int text_padding_per_side_ = 5;
   SDL_Renderer *renderer_;
   Text *text_;
-  InteractiveText *linked_interactive_text_;
-  bool is_highlighted_;
-  const InteractiveTextGroup group_;
-  InteractiveText *GetHighlightedOtherFromSameGroup(std::vector<InteractiveText *> all_text);
-  InteractiveText *GetHighlightedOtherFromDifferentGroup(std::vector<InteractiveText *> all_text);
-  CancellationCircleButton *link_cancellation_circle_;
+  MatchBoard *board_;
+  const int slot_;
+
+  // Only the left word of a link draws the line and uses the cancellation circle; the circle is held by value so
+  // linking never allocates
+  CancellationCircleButton link_cancellation_circle_;
   int line_one_x1_;
   int line_one_y1_;
   int line_one_x2_;
@@ -0,0 +1,13 @@
+#ifndef CROSSLANGUAGEMATCH_INCLUDE_TEXT_INTERACTIVE_TEXT_GROUP_H_
+#define CROSSLANGUAGEMATCH_INCLUDE_TEXT_INTERACTIVE_TEXT_GROUP_H_
+
+namespace cross_language_match {
+
+enum InteractiveTextGroup {
+  LEFT = 0,
+  RIGHT = 1
+};
+
+}
+
+#endif //CROSSLANGUAGEMATCH_INCLUDE_TEXT_INTERACTIVE_TEXT_GROUP_H_
@@ -0,0 +1,70 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <SDL2/SDL.h>
+#include <SDL_ttf.h>
+
+#ifndef CROSSLANGUAGEMATCH_INCLUDE_TEXT_SDF_ATLAS_H_
+#define CROSSLANGUAGEMATCH_INCLUDE_TEXT_SDF_ATLAS_H_
+
+namespace cross_language_match {
+
+// Signed distance fields of the printable ASCII glyphs of one font, rasterized once at a reference size and packed
+// into a single 8-bit atlas. Each texel holds the distance to the nearest glyph edge, so text of any size is drawn by
+// scaling the field and thresholding it at the edge, with no further rasterization by FreeType. Characters outside
+// printable ASCII are drawn as the font's placeholder glyph.
+class SdfAtlas {
+
+ public:
+  // The font is only read while the atlas is built
+  SdfAtlas(TTF_Font *font, int reference_point_size);
+
+  SdfAtlas(const SdfAtlas &) = delete;
+  SdfAtlas &operator=(const SdfAtlas &) = delete;
+
+  // Same layout as TTF_RenderUTF8_Blended, or TTF_RenderUTF8_Blended_Wrapped when a wrap length is given; the caller
+  // owns the surface. The point size need not be whole, as text for a high density display is drawn at a multiple of
+  // it. Returns nullptr if the surface cannot be created.
+  SDL_Surface *Render(const std::string &text, float point_size, SDL_Color color, int wrap_length_pixels = -1);
+
+  std::size_t GetSizeBytes();
+
+ private:
+
+  struct Glyph {
+    // The glyph's cell in the atlas, which includes the padding the field spreads into
+    int atlas_x;
+    int atlas_y;
+    int width;
+    int height;
+    // Left edge of the cell relative to the pen position, in reference pixels
+    int origin_x;
+    int advance;
+  };
+
+  struct PlacedGlyph {
+    const Glyph *glyph;
+    int pen_x;
+    int line;
+  };
+
+  const Glyph &FindGlyph(uint32_t code_point);
+  void AddGlyph(TTF_Font *font, uint32_t code_point, int *atlas_x, int *atlas_y);
+  int LayOut(const std::string &text, float scale, int wrap_length_pixels, std::vector<PlacedGlyph> *placed_glyphs);
+  void DrawGlyph(const PlacedGlyph &placed_glyph, float scale, SDL_Surface *surface, Uint8 alpha);
+  float SampleDistance(const Glyph &glyph, float x, float y);
+
+  const int reference_point_size_;
+  int font_height_;
+  int line_skip_;
+
+  std::vector<Glyph> glyphs_;
+  std::vector<uint8_t> atlas_;
+  int atlas_width_;
+  int atlas_height_;
+
+};
+
+}
+
+#endif //CROSSLANGUAGEMATCH_INCLUDE_TEXT_SDF_ATLAS_H_
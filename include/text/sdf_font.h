@@ -0,0 +1,29 @@
+#include <string>
+#include <SDL2/SDL.h>
+#include "text/sdf_atlas.h"
+
+#ifndef CROSSLANGUAGEMATCH_INCLUDE_TEXT_SDF_FONT_H_
+#define CROSSLANGUAGEMATCH_INCLUDE_TEXT_SDF_FONT_H_
+
+namespace cross_language_match {
+
+// A font at one point size, drawn from a distance field atlas shared by every size. Taking another size costs nothing
+// but this object.
+class SdfFont {
+
+ public:
+  SdfFont(SdfAtlas *atlas, int point_size);
+
+  // Draws the text at the given number of pixels per point, wrapping at the same length in points; the caller owns the
+  // surface. Returns nullptr if it cannot be created.
+  SDL_Surface *Render(const std::string &text, SDL_Color color, int wrap_length_pixels = -1, float pixel_scale = 1);
+
+ private:
+  SdfAtlas *atlas_;
+  const int point_size_;
+
+};
+
+}
+
+#endif //CROSSLANGUAGEMATCH_INCLUDE_TEXT_SDF_FONT_H_
@@ -0,0 +1,69 @@
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <SDL2/SDL.h>
+#include <SDL_ttf.h>
+#include "text/font_chain.h"
+
+#ifndef CROSSLANGUAGEMATCH_INCLUDE_TEXT_SHAPED_TEXT_CACHE_H_
+#define CROSSLANGUAGEMATCH_INCLUDE_TEXT_SHAPED_TEXT_CACHE_H_
+
+namespace cross_language_match {
+
+// Runs of words shaped and rasterized by SDL_ttf, keyed by font, color and string. A font is opened at one point size,
+// so the font also stands for the size. Decks repeat their words across rounds and replays, and a word drawn again is
+// copied from the cache instead of being shaped again. The cache is bounded by the total size of its surfaces; when a
+// word pushes it over the bound, the least recently used runs are removed before the next word is drawn.
+class ShapedTextCache {
+
+ public:
+  static const std::size_t kDefaultMaxSizeBytes = 8 * 1024 * 1024;
+
+  explicit ShapedTextCache(std::size_t max_size_bytes = kDefaultMaxSizeBytes);
+  ~ShapedTextCache();
+
+  ShapedTextCache(const ShapedTextCache &) = delete;
+  ShapedTextCache &operator=(const ShapedTextCache &) = delete;
+
+  // Draws each run of the text from the font the chain gives it, on a shared baseline. The surface is owned by the
+  // cache and valid until the next call; returns nullptr if a run cannot be rendered.
+  SDL_Surface *Render(FontChain *font_chain, const std::string &text, SDL_Color color);
+
+  // Hit rate and the time taken to shape and rasterize each run that missed
+  void PrintStats();
+
+ private:
+
+  struct CachedRun {
+    std::string key;
+    SDL_Surface *surface;
+  };
+
+  SDL_Surface *RenderRun(const FontRun &run, const std::string &text, SDL_Color color);
+  SDL_Surface *ComposeRuns(const std::vector<FontRun> &runs, const std::vector<SDL_Surface *> &run_surfaces);
+  void EvictToSize();
+
+  const std::size_t max_size_bytes_;
+  std::size_t size_bytes_ = 0;
+
+  // Most recently used first
+  std::list<CachedRun> runs_;
+  std::unordered_map<std::string, std::list<CachedRun>::iterator> runs_by_key_;
+  // The last word drawn in more than one run
+  SDL_Surface *composed_surface_ = nullptr;
+  std::vector<FontRun> segmented_runs_;
+
+  uint64_t hit_count_ = 0;
+  uint64_t miss_count_ = 0;
+  uint64_t eviction_count_ = 0;
+  double total_shaping_ms_ = 0;
+  double max_shaping_ms_ = 0;
+
+};
+
+}
+
+#endif //CROSSLANGUAGEMATCH_INCLUDE_TEXT_SHAPED_TEXT_CACHE_H_
@@ -2,15 +2,23 @@
 #include <SDL_ttf.h>
 #include <string>
 #include "shape/rectangle.h"
+#include "text/font_chain.h"
+#include "text/sdf_font.h"
+#include "text/shaped_text_cache.h"
 
 #ifndef CROSSLANGUAGEMATCH_INCLUDE_TEXT_H_
 #define CROSSLANGUAGEMATCH_INCLUDE_TEXT_H_
 
 namespace cross_language_match {
 
+// Text is sized in window coordinates but rasterized at the renderer's scale, so that it stays sharp on high density
+// displays; it is rasterized again when it is drawn after the scale has changed.
 class Text : public Rectangle {
  public:
-  Text(SDL_Renderer *renderer, TTF_Font *font, SDL_Color color, std::string text, int wrap_length_pixels = -1);
+  Text(SDL_Renderer *renderer, SdfFont *font, SDL_Color color, std::string text, int wrap_length_pixels = -1);
+  // Draws each run of the text from the font the chain gives it, on a shared baseline, through the chain's shaped
+  // text cache
+  Text(SDL_Renderer *renderer, FontChain *font_chain, SDL_Color color, std::string text);
   ~Text();
   void Free();
   void SetWidth(int width) override;
@@ -18,10 +26,26 @@ class Text : public Rectangle {
   void SetColor(SDL_Color color) override;
   void Render() override;
   std::string GetString() const;
+  // Rasterizes another string in place of this one, resizing the text to fit, so that the object can be used again
+  void SetString(std::string text);
  private:
+  void Rasterize(float pixel_scale);
+  void CreateTexture(SDL_Surface *text_surface);
+
   std::string text_string_;
-  SDL_Texture *texture_;
+  SDL_Texture *texture_ = nullptr;
   SDL_Renderer *renderer_;
+
+  // Exactly one of the two is set
+  SdfFont *font_ = nullptr;
+  FontChain *font_chain_ = nullptr;
+  SDL_Color color_;
+  int wrap_length_pixels_ = -1;
+
+  // Pixels per window coordinate the texture was rasterized at, and its size in pixels
+  float pixel_scale_ = 1;
+  int texture_width_ = 0;
+  int texture_height_ = 0;
 };
 
 }
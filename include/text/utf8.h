@@ -0,0 +1,17 @@
+#include <cstdint>
+
+#ifndef CROSSLANGUAGEMATCH_INCLUDE_TEXT_UTF8_H_
+#define CROSSLANGUAGEMATCH_INCLUDE_TEXT_UTF8_H_
+
+namespace cross_language_match {
+
+static const uint32_t kReplacementCharacter = 0xFFFD;
+static const uint32_t kMaxCodePoint = 0x10FFFF;
+
+// Decodes the character starting at *text and moves *text past it; stops at the terminating NUL, which is returned
+// without moving. Malformed or overlong sequences decode to the replacement character, one byte at a time.
+uint32_t DecodeUtf8(const char **text);
+
+}
+
+#endif //CROSSLANGUAGEMATCH_INCLUDE_TEXT_UTF8_H_
@@ -1,23 +1,78 @@
+#include <cstdint>
+#include <fstream>
 #include <map>
 #include <string>
+#include <utility>
+#include <vector>
 #include "word_loader.h"
+#include "word_loader/gzip_stream_buffer.h"
 
 #ifndef CROSSLANGUAGEMATCH_INCLUDE_FILE_LOADER_H_
 #define CROSSLANGUAGEMATCH_INCLUDE_FILE_LOADER_H_
 
 namespace cross_language_match {
 
+// Reads plain text or gzip-compressed word files; the format is recognized by its leading bytes, not its name, since
+// files uploaded through the browser are always stored under the same path.
+//
+// Uncompressed files can also be read a range of lines at a time through a sparse line index: the byte offset of every
+// stride-th line, saved in a sidecar next to the file so that it is only built once. Building the index checks every
+// line's comma, so ranges read later cannot fail on a malformed line.
 class FileWordLoader : public WordLoader {
  public:
+  enum Compression {
+    UNCOMPRESSED,
+    GZIP,
+    ZSTD
+  };
+
+  static const int kDefaultLineIndexStride = 256;
+
   FileWordLoader(std::string file_path);
   ~FileWordLoader();
   WordLoader::InputError ParseAndLoadIntoMap() override;
+
+  Compression DetectCompression();
+  uint64_t GetFileSize();
+
+  // Keeps the sidecar in the given directory, named after the file's sample hash, instead of next to the file; for
+  // files that do not outlive the session themselves
+  void SetLineIndexDirectory(std::string line_index_directory);
+  // Reads the sidecar if it matches the file, and otherwise builds and saves a new one
+  WordLoader::InputError OpenLineIndex(int stride = kDefaultLineIndexStride);
+  int GetLineCount();
+  // Identifies the indexed file, from its size, a sample of its bytes and the line offsets
+  uint64_t GetLineIndexChecksum();
+  WordLoader::InputError ParseLineRange(int first_line,
+                                        int line_count,
+                                        std::vector<std::pair<std::string, std::string>> *word_pairs);
  protected:
   std::istream &OpenInputStream() override;
   void CloseInputStream() override;
  private:
+  std::string GetLineIndexPath();
+  bool ComputeSampleHash(uint64_t *sample_hash);
+  uint64_t ComputeLineIndexChecksum();
+  bool ReadLineIndex(int stride);
+  WordLoader::InputError BuildLineIndex(int stride);
+  void WriteLineIndex();
+
   std::string file_path_;
   std::ifstream *file_stream_;
+  // Only set while reading a gzip file; the stream then reads through the buffer
+  GzipStreamBuffer *gzip_buffer_ = nullptr;
+  std::istream *gzip_stream_ = nullptr;
+  bool decompression_failed_ = false;
+
+  int line_index_stride_ = 0;
+  uint64_t line_count_ = 0;
+  uint64_t indexed_file_size_ = 0;
+  uint64_t indexed_sample_hash_ = 0;
+  uint64_t line_index_checksum_ = 0;
+  // Offset of line i * line_index_stride_ at index i
+  std::vector<uint64_t> line_offsets_;
+  std::ifstream *range_stream_ = nullptr;
+  std::string line_index_directory_;
 };
 
 }
@@ -0,0 +1,46 @@
+#include <cstdio>
+#include <streambuf>
+#include <vector>
+#include <zlib.h>
+
+#ifndef CROSSLANGUAGEMATCH_INCLUDE_WORD_LOADER_GZIP_STREAM_BUFFER_H_
+#define CROSSLANGUAGEMATCH_INCLUDE_WORD_LOADER_GZIP_STREAM_BUFFER_H_
+
+namespace cross_language_match {
+
+// Read-only stream buffer that inflates a gzip file one chunk at a time, so an istream on top of it never needs more
+// than a chunk of compressed and a chunk of decompressed text in memory. Concatenated gzip members are read as one
+// stream, as gunzip does.
+class GzipStreamBuffer : public std::streambuf {
+
+ public:
+  // Takes ownership of the file
+  explicit GzipStreamBuffer(FILE *file);
+  ~GzipStreamBuffer();
+
+  GzipStreamBuffer(const GzipStreamBuffer &) = delete;
+  GzipStreamBuffer &operator=(const GzipStreamBuffer &) = delete;
+
+  // True if the compressed data was corrupt or ended early; the stream then simply ends where the damage begins
+  bool HasFailed();
+
+ protected:
+  int_type underflow() override;
+
+ private:
+
+  static const std::size_t kChunkSize = 64 * 1024;
+
+  FILE *file_;
+  z_stream stream_;
+  std::vector<char> compressed_;
+  std::vector<char> decompressed_;
+  bool at_member_end_ = false;
+  bool finished_ = false;
+  bool failed_ = false;
+
+};
+
+}
+
+#endif //CROSSLANGUAGEMATCH_INCLUDE_WORD_LOADER_GZIP_STREAM_BUFFER_H_
@@ -1,5 +1,6 @@
 #include <istream>
 #include <map>
+#include <string>
 
 #ifndef CROSSLANGUAGEMATCH_INCLUDE_WORD_LOADER_H_
 #define CROSSLANGUAGEMATCH_INCLUDE_WORD_LOADER_H_
@@ -13,10 +14,18 @@ class WordLoader {
     NONE,
     LINE_CONTAINS_MORE_THAN_ONE_COMMA,
     LINE_CONTAINS_NO_COMMA,
-    FILE_NOT_FOUND
+    FILE_NOT_FOUND,
+    UNSUPPORTED_COMPRESSION,
+    CORRUPT_COMPRESSED_FILE
   };
+  // Loaders are deleted through this class, as decks that read their lines on demand hold one
+  virtual ~WordLoader() = default;
   virtual InputError ParseAndLoadIntoMap();
-  std::map<std::string, std::string> GetWordPairMap();
+  // Valid until the loader parses again or is deleted
+  const std::map<std::string, std::string> &GetWordPairMap();
+
+  // Every line of a word file must be exactly one pair, separated by a single comma
+  static InputError SplitLine(const std::string &line, std::string *left_word, std::string *right_word);
 
  protected:
   virtual std::istream &OpenInputStream() = 0;
@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <boost/format.hpp>
+#include <zlib.h>
+#include "asset/asset_bundle.h"
+#include <emscripten.h>
+
+namespace cross_language_match {
+
+// Adding 16 to the window bits makes zlib expect a gzip header and trailer rather than a raw zlib stream
+static const int kGzipWindowBits = 15 + 16;
+
+AssetBundle::AssetBundle(std::string base_url) : base_url_(base_url) {}
+
+const std::vector<char> &AssetBundle::GetAsset(const std::string &asset_path) {
+
+  auto found = assets_.find(asset_path);
+  if (found != assets_.end()) {
+    return found->second;
+  }
+
+  auto start_time = std::chrono::steady_clock::now();
+  std::string url = base_url_ + "/" + asset_path + ".gz";
+  void *compressed = nullptr;
+  int compressed_size = 0;
+  int error = 0;
+  emscripten_wget_data(url.c_str(), &compressed, &compressed_size, &error);
+  if (error != 0) {
+    throw std::runtime_error(boost::str(boost::format("Failed to fetch asset %1%") % url));
+  }
+  double fetch_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+
+  start_time = std::chrono::steady_clock::now();
+  std::vector<char> &asset = assets_[asset_path];
+  try {
+    Inflate(asset_path, (const char *) compressed, compressed_size, &asset);
+  } catch (...) {
+    free(compressed);
+    assets_.erase(asset_path);
+    throw;
+  }
+  free(compressed);
+  double inflate_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+
+  printf("Fetched asset %s (%d KB compressed, %d KB inflated) in %.1f ms, inflated in %.1f ms\n",
+         asset_path.c_str(),
+         compressed_size / 1024,
+         (int) (asset.size() / 1024),
+         fetch_ms,
+         inflate_ms);
+
+  return asset;
+
+}
+
+void AssetBundle::Inflate(const std::string &asset_path,
+                          const char *compressed,
+                          int compressed_size,
+                          std::vector<char> *asset) {
+
+  // The gzip trailer ends with the inflated size modulo 2^32, which sizes the output in one go for any real asset
+  std::size_t expected_size = 0;
+  if (compressed_size >= 4) {
+    const unsigned char *size_bytes = (const unsigned char *) compressed + compressed_size - 4;
+    expected_size = size_bytes[0] | size_bytes[1] << 8 | size_bytes[2] << 16 | (std::size_t) size_bytes[3] << 24;
+  }
+  // Deflate cannot shrink data by more than about 1032 to 1, so a damaged trailer cannot ask for more than that
+  expected_size = std::min(expected_size, (std::size_t) compressed_size * 1032);
+  asset->resize(std::max(expected_size, (std::size_t) 1024));
+
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  if (inflateInit2(&stream, kGzipWindowBits) != Z_OK) {
+    throw std::runtime_error(boost::str(boost::format("Unable to initialize zlib: %1%") % stream.msg));
+  }
+  stream.next_in = (Bytef *) compressed;
+  stream.avail_in = (uInt) compressed_size;
+
+  int result = Z_OK;
+  while (result == Z_OK) {
+    if (stream.total_out == asset->size()) {
+      asset->resize(asset->size() * 2);
+    }
+    stream.next_out = (Bytef *) asset->data() + stream.total_out;
+    stream.avail_out = (uInt) (asset->size() - stream.total_out);
+    result = inflate(&stream, Z_NO_FLUSH);
+  }
+  asset->resize(stream.total_out);
+  inflateEnd(&stream);
+
+  if (result != Z_STREAM_END) {
+    throw std::runtime_error(boost::str(boost::format("Asset %1% is not valid gzip data") % asset_path));
+  }
+
+}
+
+}
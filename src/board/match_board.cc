@@ -0,0 +1,159 @@
+#include "board/match_board.h"
+
+namespace cross_language_match {
+
+void MatchBoard::Clear() {
+
+  word_ids_.clear();
+  columns_.clear();
+  links_.clear();
+  highlighted_.clear();
+  expected_partner_word_ids_.clear();
+
+  highlighted_slot_per_column_[LEFT] = kNoSlot;
+  highlighted_slot_per_column_[RIGHT] = kNoSlot;
+
+  pair_count_ = 0;
+  linked_pair_count_ = 0;
+  correct_pair_count_ = 0;
+
+}
+
+int MatchBoard::AddSlot(int word_id, InteractiveTextGroup column, int expected_partner_word_id) {
+
+  word_ids_.push_back(word_id);
+  columns_.push_back(column);
+  links_.push_back(kNoSlot);
+  highlighted_.push_back(false);
+  expected_partner_word_ids_.push_back(expected_partner_word_id);
+
+  if (column == LEFT) {
+    pair_count_++;
+  }
+
+  return (int) word_ids_.size() - 1;
+
+}
+
+int MatchBoard::GetSlotCount() {
+  return (int) word_ids_.size();
+}
+
+int MatchBoard::GetWordId(int slot) {
+  return word_ids_[slot];
+}
+
+void MatchBoard::SetWordId(int slot, int word_id) {
+  word_ids_[slot] = word_id;
+}
+
+void MatchBoard::SetExpectedPartnerWordId(int slot, int expected_partner_word_id) {
+  expected_partner_word_ids_[slot] = expected_partner_word_id;
+}
+
+InteractiveTextGroup MatchBoard::GetColumn(int slot) {
+  return columns_[slot];
+}
+
+void MatchBoard::Link(int slot, int other_slot) {
+
+  if (links_[slot] != kNoSlot || links_[other_slot] != kNoSlot || columns_[slot] == columns_[other_slot]) {
+    return;
+  }
+
+  links_[slot] = other_slot;
+  links_[other_slot] = slot;
+
+  linked_pair_count_++;
+  if (IsLinkCorrect(slot)) {
+    correct_pair_count_++;
+  }
+
+}
+
+void MatchBoard::Unlink(int slot) {
+
+  int other_slot = links_[slot];
+  if (other_slot == kNoSlot) {
+    return;
+  }
+
+  linked_pair_count_--;
+  if (IsLinkCorrect(slot)) {
+    correct_pair_count_--;
+  }
+
+  links_[slot] = kNoSlot;
+  links_[other_slot] = kNoSlot;
+
+}
+
+int MatchBoard::GetLink(int slot) {
+  return links_[slot];
+}
+
+bool MatchBoard::IsLinked(int slot) {
+  return links_[slot] != kNoSlot;
+}
+
+bool MatchBoard::IsLinkCorrect(int slot) {
+
+  if (links_[slot] == kNoSlot) {
+    return false;
+  }
+
+  int left_slot = columns_[slot] == LEFT ? slot : links_[slot];
+  return word_ids_[links_[left_slot]] == expected_partner_word_ids_[left_slot];
+
+}
+
+int MatchBoard::GetPairCount() {
+  return pair_count_;
+}
+
+int MatchBoard::GetLinkedPairCount() {
+  return linked_pair_count_;
+}
+
+int MatchBoard::GetCorrectPairCount() {
+  return correct_pair_count_;
+}
+
+bool MatchBoard::AreAllPairsLinked() {
+  return linked_pair_count_ == pair_count_;
+}
+
+bool MatchBoard::AreAllPairsLinkedAndCorrect() {
+  return correct_pair_count_ == pair_count_;
+}
+
+void MatchBoard::AddHighlight(int slot) {
+
+  int previously_highlighted_slot = highlighted_slot_per_column_[columns_[slot]];
+  if (previously_highlighted_slot != kNoSlot) {
+    highlighted_[previously_highlighted_slot] = false;
+  }
+
+  highlighted_[slot] = true;
+  highlighted_slot_per_column_[columns_[slot]] = slot;
+
+}
+
+void MatchBoard::RemoveHighlight(int slot) {
+
+  highlighted_[slot] = false;
+  if (highlighted_slot_per_column_[columns_[slot]] == slot) {
+    highlighted_slot_per_column_[columns_[slot]] = kNoSlot;
+  }
+
+}
+
+bool MatchBoard::IsHighlighted(int slot) {
+  return highlighted_[slot];
+}
+
+int MatchBoard::GetHighlightedSlot(InteractiveTextGroup column) {
+  return highlighted_slot_per_column_[column];
+}
+
+}
@@ -30,4 +30,8 @@ void LabeledButton::Render() {
   label_->Render();
 }
 
+void LabeledButton::SetLabel(Text *label) {
+  label_ = label;
+}
+
 }
\ No newline at end of file
@@ -0,0 +1,611 @@
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <boost/format.hpp>
+#include "deck/deck.h"
+#include "hash/fnv1a.h"
+#include "storage/binary_io.h"
+#include "word_loader/file_word_loader.h"
+
+namespace cross_language_match {
+
+Deck::Deck(const std::map<std::string, std::string> &word_pairs, unsigned int seed) : random_engine_(seed) {
+
+  string_offsets_.reserve(word_pairs.size() * 2);
+  for (auto &word_pair : word_pairs) {
+    AddString(word_pair.first);
+    AddString(word_pair.second);
+  }
+
+  pair_count_ = (int) word_pairs.size();
+  AssignWordIds(0, &left_word_ids_);
+  AssignWordIds(1, &right_word_ids_);
+
+  // The offsets follow from the characters, so hashing the characters identifies the deck
+  content_hash_ = Fnv1a64(characters_.data(), characters_.size());
+
+  ResetDrawOrder();
+
+}
+
+Deck::Deck(unsigned int seed) : random_engine_(seed) {}
+
+Deck::~Deck() {
+  if (page_file_ != nullptr) {
+    fclose(page_file_);
+    page_file_ = nullptr;
+  }
+  delete line_loader_;
+  line_loader_ = nullptr;
+}
+
+void Deck::ResetDrawOrder() {
+
+  draw_order_.resize(GetPairCount());
+  for (int pair_index = 0; pair_index < GetPairCount(); pair_index++) {
+    draw_order_[pair_index] = pair_index;
+  }
+  draw_cursor_ = 0;
+  draw_positions_.clear();
+
+}
+
+static const char kCompiledDeckMagic[] = "CLMDECK1";
+
+Deck *Deck::ReadCompiled(const std::string &path,
+                         uint64_t expected_content_hash,
+                         unsigned int seed,
+                         std::size_t memory_budget_bytes) {
+  return ReadCompiled(path, &expected_content_hash, seed, memory_budget_bytes);
+}
+
+Deck *Deck::ReadCompiledUnchecked(const std::string &path, unsigned int seed, std::size_t memory_budget_bytes) {
+  return ReadCompiled(path, nullptr, seed, memory_budget_bytes);
+}
+
+Deck *Deck::ReadCompiled(const std::string &path,
+                         const uint64_t *expected_content_hash,
+                         unsigned int seed,
+                         std::size_t memory_budget_bytes) {
+
+  FILE *file = fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    return nullptr;
+  }
+
+  Deck *deck = new Deck(seed);
+  deck->memory_budget_bytes_ = memory_budget_bytes;
+  char magic[sizeof(kCompiledDeckMagic) - 1];
+  bool read = fread(magic, 1, sizeof(magic), file) == sizeof(magic)
+      && memcmp(magic, kCompiledDeckMagic, sizeof(magic)) == 0
+      && ReadValue(file, &deck->content_hash_)
+      && (expected_content_hash == nullptr || deck->content_hash_ == *expected_content_hash)
+      && SkipSection(file, sizeof(char), &deck->paged_characters_);
+
+  // Over budget, everything but the draw order is left in the file, which stays open to page it in from
+  bool paged = read && deck->paged_characters_.count > memory_budget_bytes;
+  if (paged) {
+
+    off_t file_size = 0;
+    read = SkipSection(file, sizeof(uint32_t), &deck->paged_string_offsets_)
+        && SkipSection(file, sizeof(int), &deck->paged_left_word_ids_)
+        && SkipSection(file, sizeof(int), &deck->paged_right_word_ids_)
+        && fseeko(file, 0, SEEK_END) == 0
+        && (file_size = ftello(file)) >= 0
+        && deck->paged_right_word_ids_.offset + (off_t) (deck->paged_right_word_ids_.count * sizeof(int)) <= file_size
+        && deck->paged_string_offsets_.count == deck->paged_left_word_ids_.count * 2
+        && deck->paged_right_word_ids_.count == deck->paged_left_word_ids_.count
+        && deck->paged_left_word_ids_.count <= INT32_MAX;
+    deck->page_file_ = file;
+    deck->pair_count_ = (int) deck->paged_left_word_ids_.count;
+
+  } else if (read) {
+
+    deck->characters_.resize(deck->paged_characters_.count);
+    read = fseeko(file, deck->paged_characters_.offset, SEEK_SET) == 0
+        && fread(deck->characters_.data(), 1, deck->characters_.size(), file) == deck->characters_.size()
+        && ReadVector(file, &deck->string_offsets_, UINT32_MAX)
+        && ReadVector(file, &deck->left_word_ids_, UINT32_MAX)
+        && ReadVector(file, &deck->right_word_ids_, UINT32_MAX)
+        && deck->string_offsets_.size() == deck->left_word_ids_.size() * 2
+        && deck->right_word_ids_.size() == deck->left_word_ids_.size();
+    deck->paged_characters_ = {0, 0};
+    deck->pair_count_ = (int) deck->left_word_ids_.size();
+    read = read && deck->IsIndexValid();
+    fclose(file);
+
+  } else {
+    fclose(file);
+  }
+
+  if (!read) {
+    // Closes the file in paged mode
+    delete deck;
+    return nullptr;
+  }
+
+  deck->ResetDrawOrder();
+  return deck;
+
+}
+
+Deck *Deck::OpenLineIndexed(FileWordLoader *line_loader, unsigned int seed, std::size_t memory_budget_bytes) {
+
+  Deck *deck = new Deck(seed);
+  deck->line_loader_ = line_loader;
+  deck->memory_budget_bytes_ = memory_budget_bytes;
+  deck->pair_count_ = line_loader->GetLineCount();
+  deck->content_hash_ = line_loader->GetLineIndexChecksum();
+  deck->ResetDrawOrder();
+  return deck;
+
+}
+
+bool Deck::SkipSection(FILE *file, std::size_t element_size, PagedSection *section) {
+  return ReadValue(file, &section->count)
+      && section->count <= UINT32_MAX
+      && (section->offset = ftello(file)) >= 0
+      && fseeko(file, (off_t) (section->count * element_size), SEEK_CUR) == 0;
+}
+
+bool Deck::IsIndexValid() {
+
+  // Every string must start inside the buffer, and the buffer must end in a terminator for the last one
+  if (!characters_.empty() && characters_.back() != '\0') {
+    return false;
+  }
+  for (uint32_t string_offset : string_offsets_) {
+    if (string_offset >= characters_.size()) {
+      return false;
+    }
+  }
+  // IDs are only compared with each other; an edited deck has IDs beyond its pair indices
+  for (int pair_index = 0; pair_index < pair_count_; pair_index++) {
+    if (left_word_ids_[pair_index] < 0 || right_word_ids_[pair_index] < 0) {
+      return false;
+    }
+  }
+  return true;
+
+}
+
+bool Deck::WriteCompiled(const std::string &path) {
+
+  // Compiling needs every line parsed and word IDs assigned over the whole deck, which is what this mode avoids
+  if (line_loader_ != nullptr) {
+    return false;
+  }
+
+  FILE *file = fopen(path.c_str(), "wb");
+  if (file == nullptr) {
+    return false;
+  }
+
+  bool written = fwrite(kCompiledDeckMagic, 1, sizeof(kCompiledDeckMagic) - 1, file) == sizeof(kCompiledDeckMagic) - 1
+      && WriteValue(file, GetContentHash())
+      && (IsPaged()
+          ? WriteSection(file, paged_characters_, sizeof(char))
+              && WriteSection(file, paged_string_offsets_, sizeof(uint32_t))
+              && WriteSection(file, paged_left_word_ids_, sizeof(int))
+              && WriteSection(file, paged_right_word_ids_, sizeof(int))
+          : WriteVector(file, characters_)
+              && WriteVector(file, string_offsets_)
+              && WriteVector(file, left_word_ids_)
+              && WriteVector(file, right_word_ids_));
+  fclose(file);
+
+  return written;
+
+}
+
+uint64_t Deck::GetContentHash() {
+  if (content_hash_is_stale_) {
+    content_hash_ = Fnv1a64(characters_.data(), characters_.size());
+    content_hash_is_stale_ = false;
+  }
+  return content_hash_;
+}
+
+bool Deck::WriteSection(FILE *file, const PagedSection &section, std::size_t element_size) {
+
+  // Same layout as WriteVector, copied from the page file a chunk at a time so that the section never becomes
+  // resident as a whole
+  if (!WriteValue(file, section.count) || fseeko(page_file_, section.offset, SEEK_SET) != 0) {
+    return false;
+  }
+  char buffer[64 * 1024];
+  uint64_t remaining = section.count * element_size;
+  while (remaining > 0) {
+    std::size_t chunk = (std::size_t) std::min<uint64_t>(remaining, sizeof(buffer));
+    if (fread(buffer, 1, chunk, page_file_) != chunk || fwrite(buffer, 1, chunk, file) != chunk) {
+      return false;
+    }
+    remaining -= chunk;
+  }
+  return true;
+
+}
+
+bool Deck::IsPaged() {
+  return page_file_ != nullptr || line_loader_ != nullptr;
+}
+
+uint64_t Deck::GetStringBytes() {
+  if (line_loader_ != nullptr) {
+    return line_loader_->GetFileSize();
+  }
+  return IsPaged() ? paged_characters_.count : characters_.size();
+}
+
+std::size_t Deck::GetIndexBytes() {
+  return string_offsets_.capacity() * sizeof(uint32_t)
+      + (left_word_ids_.capacity() + right_word_ids_.capacity() + draw_order_.capacity() + draw_positions_.capacity())
+          * sizeof(int);
+}
+
+std::size_t Deck::GetResidentBytes() {
+  return GetIndexBytes() + characters_.capacity() + resident_page_bytes_;
+}
+
+std::size_t Deck::GetPeakResidentBytes() {
+  return GetIndexBytes() + characters_.capacity() + peak_resident_page_bytes_;
+}
+
+int Deck::GetPageLoadCount() {
+  return page_load_count_;
+}
+
+bool Deck::WriteState(FILE *file) {
+
+  // The standard engines only expose their state through stream operators
+  std::ostringstream engine_state;
+  engine_state << random_engine_;
+  std::string engine_state_string = engine_state.str();
+  std::vector<char> engine_state_bytes(engine_state_string.begin(), engine_state_string.end());
+
+  return WriteVector(file, draw_order_)
+      && WriteValue(file, draw_cursor_)
+      && WriteVector(file, engine_state_bytes);
+
+}
+
+bool Deck::ReadState(FILE *file) {
+
+  std::vector<int> draw_order;
+  int draw_cursor = 0;
+  std::vector<char> engine_state_bytes;
+  if (!ReadVector(file, &draw_order, (uint64_t) GetPairCount())
+      || !ReadValue(file, &draw_cursor)
+      || !ReadVector(file, &engine_state_bytes, 1 << 16)
+      || draw_order.size() != (std::size_t) GetPairCount()
+      || draw_cursor < 0 || draw_cursor > GetPairCount()) {
+    return false;
+  }
+  for (int pair_index : draw_order) {
+    if (pair_index < 0 || pair_index >= GetPairCount()) {
+      return false;
+    }
+  }
+
+  std::istringstream engine_state(std::string(engine_state_bytes.begin(), engine_state_bytes.end()));
+  std::mt19937 random_engine;
+  engine_state >> random_engine;
+  if (engine_state.fail()) {
+    return false;
+  }
+
+  draw_order_.swap(draw_order);
+  draw_cursor_ = draw_cursor;
+  draw_positions_.clear();
+  random_engine_ = random_engine;
+  return true;
+
+}
+
+void Deck::AddString(const std::string &word) {
+  string_offsets_.push_back((uint32_t) characters_.size());
+  characters_.insert(characters_.end(), word.begin(), word.end());
+  characters_.push_back('\0');
+}
+
+void Deck::AssignWordIds(int side, std::vector<int> *word_ids) {
+
+  // Sorting pair indices by string groups equal strings together; each group takes the ID of its first entry
+  std::vector<int> order(GetPairCount());
+  for (int pair_index = 0; pair_index < GetPairCount(); pair_index++) {
+    order[pair_index] = pair_index;
+  }
+  auto string_of = [this, side](int pair_index) {
+    return &characters_[string_offsets_[pair_index * 2 + side]];
+  };
+  std::sort(order.begin(), order.end(), [&string_of](int a, int b) {
+    return strcmp(string_of(a), string_of(b)) < 0;
+  });
+
+  word_ids->assign(GetPairCount(), 0);
+  int word_id = -1;
+  for (int i = 0; i < (int) order.size(); i++) {
+    if (i == 0 || strcmp(string_of(order[i]), string_of(order[i - 1])) != 0) {
+      word_id = order[i];
+    }
+    (*word_ids)[order[i]] = word_id;
+  }
+
+}
+
+int Deck::GetPairCount() {
+  return pair_count_;
+}
+
+const char *Deck::GetLeftWord(int pair_index) {
+  return GetString(pair_index * 2);
+}
+
+const char *Deck::GetRightWord(int pair_index) {
+  return GetString(pair_index * 2 + 1);
+}
+
+const char *Deck::GetString(int string_index) {
+
+  if (!IsPaged()) {
+    return &characters_[string_offsets_[string_index]];
+  }
+
+  const Page &page = GetPage(string_index / 2 / kPairsPerPage);
+  return &page.characters[page.string_offsets[string_index - page.first_pair * 2] - page.first_character];
+
+}
+
+const Deck::Page &Deck::GetPage(int page_index) {
+
+  page_use_counter_++;
+  for (Page &page : resident_pages_) {
+    if (page.page_index == page_index) {
+      page.last_use = page_use_counter_;
+      return page;
+    }
+  }
+
+  Page page;
+  LoadPage(page_index, &page);
+  std::size_t page_bytes = page.characters.size() + page.string_offsets.size() * sizeof(uint32_t)
+      + (page.left_word_ids.size() + page.right_word_ids.size()) * sizeof(int);
+
+  // The most recently used page is always kept, so the string handed out just before this one stays valid. Moving a
+  // page keeps its buffers in place, so pointers into surviving pages stay valid as well.
+  while (resident_pages_.size() > 1 && resident_page_bytes_ + page_bytes > memory_budget_bytes_) {
+    auto least_recently_used = std::min_element(resident_pages_.begin(),
+                                                resident_pages_.end(),
+                                                [](const Page &a, const Page &b) {
+                                                  return a.last_use < b.last_use;
+                                                });
+    resident_page_bytes_ -= least_recently_used->characters.size()
+        + least_recently_used->string_offsets.size() * sizeof(uint32_t)
+        + (least_recently_used->left_word_ids.size() + least_recently_used->right_word_ids.size()) * sizeof(int);
+    resident_pages_.erase(least_recently_used);
+  }
+
+  resident_page_bytes_ += page_bytes;
+  peak_resident_page_bytes_ = std::max(peak_resident_page_bytes_, resident_page_bytes_);
+  page_load_count_++;
+  page.last_use = page_use_counter_;
+  resident_pages_.push_back(std::move(page));
+  return resident_pages_.back();
+
+}
+
+void Deck::LoadPage(int page_index, Page *page) {
+
+  if (line_loader_ != nullptr) {
+    LoadLinePage(page_index, page);
+    return;
+  }
+
+  int first_pair = page_index * kPairsPerPage;
+  int end_pair = std::min(first_pair + kPairsPerPage, GetPairCount());
+  int page_pair_count = end_pair - first_pair;
+  bool is_last_page = end_pair == GetPairCount();
+
+  // A page's characters run from its first left word up to the next page's first left word, so one offset past the
+  // page is read as well
+  page->page_index = page_index;
+  page->first_pair = first_pair;
+  page->string_offsets.resize(page_pair_count * 2 + (is_last_page ? 0 : 1));
+  ReadSection(paged_string_offsets_, (uint64_t) first_pair * 2, page->string_offsets.size(), sizeof(uint32_t),
+              page->string_offsets.data());
+  page->first_character = page->string_offsets.front();
+  uint64_t end_character = is_last_page ? paged_characters_.count : page->string_offsets.back();
+  if (!is_last_page) {
+    page->string_offsets.pop_back();
+  }
+
+  // Offsets are checked as pages arrive rather than all up front, which would mean reading the whole index
+  for (std::size_t i = 0; i < page->string_offsets.size(); i++) {
+    if (page->string_offsets[i] >= end_character || (i > 0 && page->string_offsets[i] <= page->string_offsets[i - 1])) {
+      throw std::runtime_error(
+          boost::str(boost::format("Page %1% of the deck has invalid string offsets") % page_index)
+      );
+    }
+  }
+
+  page->characters.resize(end_character - page->first_character);
+  ReadSection(paged_characters_, page->first_character, page->characters.size(), sizeof(char),
+              page->characters.data());
+  if (page->characters.back() != '\0') {
+    throw std::runtime_error(boost::str(boost::format("Page %1% of the deck has an unterminated string") % page_index));
+  }
+
+  page->left_word_ids.resize(page_pair_count);
+  page->right_word_ids.resize(page_pair_count);
+  ReadSection(paged_left_word_ids_, first_pair, page_pair_count, sizeof(int), page->left_word_ids.data());
+  ReadSection(paged_right_word_ids_, first_pair, page_pair_count, sizeof(int), page->right_word_ids.data());
+
+}
+
+void Deck::LoadLinePage(int page_index, Page *page) {
+
+  int first_pair = page_index * kPairsPerPage;
+  int page_pair_count = std::min(first_pair + kPairsPerPage, GetPairCount()) - first_pair;
+
+  std::vector<std::pair<std::string, std::string>> word_pairs;
+  word_pairs.reserve(page_pair_count);
+  if (line_loader_->ParseLineRange(first_pair, page_pair_count, &word_pairs) != WordLoader::InputError::NONE
+      || (int) word_pairs.size() != page_pair_count) {
+    throw std::runtime_error(boost::str(boost::format("Unable to read page %1% of the deck; the word file changed")
+                                            % page_index));
+  }
+
+  // Pages are packed like a compiled deck, with offsets relative to the page's own characters
+  page->page_index = page_index;
+  page->first_pair = first_pair;
+  page->first_character = 0;
+  page->string_offsets.clear();
+  page->characters.clear();
+  page->left_word_ids.clear();
+  page->right_word_ids.clear();
+  for (auto &word_pair : word_pairs) {
+    for (const std::string *word : {&word_pair.first, &word_pair.second}) {
+      page->string_offsets.push_back((uint32_t) page->characters.size());
+      page->characters.insert(page->characters.end(), word->begin(), word->end());
+      page->characters.push_back('\0');
+    }
+    // Equal strings must share an ID without a pass over the whole deck, so the ID is derived from the string
+    page->left_word_ids.push_back((int) (Fnv1a64(word_pair.first.data(), word_pair.first.size()) & INT32_MAX));
+    page->right_word_ids.push_back((int) (Fnv1a64(word_pair.second.data(), word_pair.second.size()) & INT32_MAX));
+  }
+
+}
+
+void Deck::ReadSection(const PagedSection &section,
+                       uint64_t first,
+                       uint64_t count,
+                       std::size_t element_size,
+                       void *out) {
+  if (first + count > section.count
+      || fseeko(page_file_, section.offset + (off_t) (first * element_size), SEEK_SET) != 0
+      || fread(out, element_size, count, page_file_) != count) {
+    throw std::runtime_error("Unable to read a page of the deck; the compiled deck is truncated");
+  }
+}
+
+int Deck::GetLeftWordId(int pair_index) {
+  if (!IsPaged()) {
+    return left_word_ids_[pair_index];
+  }
+  const Page &page = GetPage(pair_index / kPairsPerPage);
+  return page.left_word_ids[pair_index - page.first_pair];
+}
+
+int Deck::GetRightWordId(int pair_index) {
+  if (!IsPaged()) {
+    return right_word_ids_[pair_index];
+  }
+  const Page &page = GetPage(pair_index / kPairsPerPage);
+  return page.right_word_ids[pair_index - page.first_pair];
+}
+
+int Deck::Draw(int count, std::vector<int> *pair_indices) {
+
+  int drawn = 0;
+  while (drawn < count && draw_cursor_ < (int) draw_order_.size()) {
+
+    // One step of Fisher-Yates: the undrawn tail [draw_cursor_, size) is always a uniformly random remainder
+    std::uniform_int_distribution<int> distribution(draw_cursor_, (int) draw_order_.size() - 1);
+    SwapDrawPositions(draw_cursor_, distribution(random_engine_));
+
+    pair_indices->push_back(draw_order_[draw_cursor_]);
+    draw_cursor_++;
+    drawn++;
+
+  }
+
+  return drawn;
+
+}
+
+bool Deck::DrawPair(int pair_index) {
+
+  if (draw_positions_.empty()) {
+    draw_positions_.resize(draw_order_.size());
+    for (int position = 0; position < (int) draw_order_.size(); position++) {
+      draw_positions_[draw_order_[position]] = position;
+    }
+  }
+
+  int position = draw_positions_[pair_index];
+  if (position < draw_cursor_) {
+    return false;
+  }
+
+  // The pair trades places with the next one to be drawn; the rest of the undrawn tail is as random as it was
+  SwapDrawPositions(draw_cursor_, position);
+  draw_cursor_++;
+  return true;
+
+}
+
+void Deck::SwapDrawPositions(int position, int other_position) {
+  std::swap(draw_order_[position], draw_order_[other_position]);
+  if (!draw_positions_.empty()) {
+    draw_positions_[draw_order_[position]] = position;
+    draw_positions_[draw_order_[other_position]] = other_position;
+  }
+}
+
+int Deck::GetRemainingCount() {
+  return (int) draw_order_.size() - draw_cursor_;
+}
+
+void Deck::Reshuffle() {
+  // Every pair is undrawn again; the lazy shuffle re-randomises them as they are drawn
+  draw_cursor_ = 0;
+}
+
+void Deck::Shuffle(std::vector<int> *values) {
+  std::shuffle(values->begin(), values->end(), random_engine_);
+}
+
+int Deck::AddPair(const std::string &left_word,
+                  const std::string &right_word,
+                  int left_word_id,
+                  int right_word_id) {
+
+  if (IsPaged()) {
+    throw std::runtime_error("A paged deck cannot be edited");
+  }
+
+  // No pair has used the new index as an ID yet, so it can serve as the ID of a new string on either side
+  int pair_index = pair_count_;
+  AddString(left_word);
+  AddString(right_word);
+  left_word_ids_.push_back(left_word_id == kNewWordId ? pair_index : left_word_id);
+  right_word_ids_.push_back(right_word_id == kNewWordId ? pair_index : right_word_id);
+  pair_count_++;
+
+  // Appending to the undrawn tail keeps the lazy shuffle uniform over what is left
+  draw_order_.push_back(pair_index);
+  if (!draw_positions_.empty()) {
+    draw_positions_.push_back((int) draw_order_.size() - 1);
+  }
+  content_hash_is_stale_ = true;
+  return pair_index;
+
+}
+
+void Deck::SetRightWord(int pair_index, const std::string &right_word, int right_word_id) {
+
+  if (IsPaged()) {
+    throw std::runtime_error("A paged deck cannot be edited");
+  }
+
+  // The pair's index may be the ID other pairs share for its old string, so a new string takes a fresh ID instead
+  right_word_ids_[pair_index] = right_word_id == kNewWordId ? next_edited_word_id_-- : right_word_id;
+
+  string_offsets_[pair_index * 2 + 1] = (uint32_t) characters_.size();
+  characters_.insert(characters_.end(), right_word.begin(), right_word.end());
+  characters_.push_back('\0');
+  content_hash_is_stale_ = true;
+
+}
+
+}
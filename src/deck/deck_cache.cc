@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <utime.h>
+#include <boost/format.hpp>
+#include "deck/deck_cache.h"
+#include "hash/xxhash64.h"
+#include "storage/binary_io.h"
+
+namespace cross_language_match {
+
+static const char kDeckFileExtension[] = ".deck";
+static const char kStatsFileName[] = "stats";
+
+DeckCache::DeckCache(std::string directory, uint64_t max_size_bytes, std::size_t deck_memory_budget_bytes)
+    : directory_(directory),
+      max_size_bytes_(max_size_bytes),
+      deck_memory_budget_bytes_(deck_memory_budget_bytes) {
+
+  // Already existing is the usual case
+  mkdir(directory_.c_str(), 0755);
+  ReadStats();
+
+}
+
+bool DeckCache::HashSourceFile(const std::string &path, uint64_t *source_hash) {
+
+  FILE *file = fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    return false;
+  }
+
+  // Hashed chunk by chunk, so a large upload is never held in memory a second time
+  XxHash64State state;
+  char buffer[64 * 1024];
+  std::size_t read_count;
+  while ((read_count = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    state.Update(buffer, read_count);
+  }
+  bool read = ferror(file) == 0;
+  fclose(file);
+
+  if (!read) {
+    return false;
+  }
+  *source_hash = state.Digest();
+  return true;
+
+}
+
+Deck *DeckCache::Find(uint64_t source_hash, unsigned int seed) {
+
+  std::string path = GetDeckPath(source_hash);
+  Deck *deck = Deck::ReadCompiledUnchecked(path, seed, deck_memory_budget_bytes_);
+
+  if (deck == nullptr) {
+    miss_count_++;
+  } else {
+    hit_count_++;
+    // The modification time doubles as the last use time for eviction
+    utime(path.c_str(), nullptr);
+  }
+  WriteStats();
+
+  printf("Deck cache %s for %016llx (%llu hits, %llu misses, %llu evictions)\n",
+         deck == nullptr ? "miss" : "hit",
+         (unsigned long long) source_hash,
+         (unsigned long long) hit_count_,
+         (unsigned long long) miss_count_,
+         (unsigned long long) eviction_count_);
+
+  return deck;
+
+}
+
+bool DeckCache::Store(uint64_t source_hash, Deck *deck) {
+
+  std::string path = GetDeckPath(source_hash);
+  std::string temporary_path = path + ".tmp";
+
+  if (!deck->WriteCompiled(temporary_path) || rename(temporary_path.c_str(), path.c_str()) != 0) {
+    printf("Warning: unable to write %s to the deck cache\n", path.c_str());
+    remove(temporary_path.c_str());
+    return false;
+  }
+
+  EvictToSize(path);
+  return true;
+
+}
+
+Deck *DeckCache::Open(uint64_t source_hash, unsigned int seed) {
+  return Deck::ReadCompiledUnchecked(GetDeckPath(source_hash), seed, deck_memory_budget_bytes_);
+}
+
+std::size_t DeckCache::GetDeckMemoryBudgetBytes() {
+  return deck_memory_budget_bytes_;
+}
+
+uint64_t DeckCache::GetHitCount() {
+  return hit_count_;
+}
+
+uint64_t DeckCache::GetMissCount() {
+  return miss_count_;
+}
+
+uint64_t DeckCache::GetEvictionCount() {
+  return eviction_count_;
+}
+
+std::string DeckCache::GetDeckPath(uint64_t source_hash) {
+  return boost::str(boost::format("%1%/%2$016x%3%") % directory_ % source_hash % kDeckFileExtension);
+}
+
+void DeckCache::EvictToSize(const std::string &kept_path) {
+
+  struct CachedDeck {
+    std::string path;
+    uint64_t size;
+    int64_t last_used_ns;
+  };
+
+  DIR *directory = opendir(directory_.c_str());
+  if (directory == nullptr) {
+    return;
+  }
+
+  std::vector<CachedDeck> decks;
+  uint64_t total_size = 0;
+  const std::size_t extension_length = sizeof(kDeckFileExtension) - 1;
+  struct dirent *entry;
+  while ((entry = readdir(directory)) != nullptr) {
+    std::size_t name_length = strlen(entry->d_name);
+    if (name_length <= extension_length
+        || strcmp(entry->d_name + name_length - extension_length, kDeckFileExtension) != 0) {
+      continue;
+    }
+    std::string path = directory_ + "/" + entry->d_name;
+    struct stat file_stat;
+    if (stat(path.c_str(), &file_stat) == 0) {
+      decks.push_back({path,
+                       (uint64_t) file_stat.st_size,
+                       (int64_t) file_stat.st_mtim.tv_sec * 1000000000 + file_stat.st_mtim.tv_nsec});
+      total_size += file_stat.st_size;
+    }
+  }
+  closedir(directory);
+
+  std::sort(decks.begin(), decks.end(), [](const CachedDeck &a, const CachedDeck &b) {
+    return a.last_used_ns < b.last_used_ns;
+  });
+
+  // The deck just stored is kept even if it alone exceeds the bound, since it is about to be played
+  for (const CachedDeck &deck : decks) {
+    if (total_size <= max_size_bytes_) {
+      break;
+    }
+    if (deck.path == kept_path) {
+      continue;
+    }
+    if (remove(deck.path.c_str()) == 0) {
+      total_size -= deck.size;
+      eviction_count_++;
+      printf("Evicted %s from the deck cache\n", deck.path.c_str());
+    }
+  }
+  WriteStats();
+
+}
+
+void DeckCache::ReadStats() {
+
+  FILE *file = fopen((directory_ + "/" + kStatsFileName).c_str(), "rb");
+  if (file == nullptr) {
+    return;
+  }
+
+  uint64_t hit_count = 0;
+  uint64_t miss_count = 0;
+  uint64_t eviction_count = 0;
+  if (ReadValue(file, &hit_count) && ReadValue(file, &miss_count) && ReadValue(file, &eviction_count)) {
+    hit_count_ = hit_count;
+    miss_count_ = miss_count;
+    eviction_count_ = eviction_count;
+  }
+  fclose(file);
+
+}
+
+void DeckCache::WriteStats() {
+
+  FILE *file = fopen((directory_ + "/" + kStatsFileName).c_str(), "wb");
+  if (file == nullptr) {
+    return;
+  }
+
+  WriteValue(file, hit_count_);
+  WriteValue(file, miss_count_);
+  WriteValue(file, eviction_count_);
+  fclose(file);
+
+}
+
+}
@@ -0,0 +1,362 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sys/stat.h>
+#include "deck/deck_watcher.h"
+#include "hash/fnv1a.h"
+#include "word_loader/file_word_loader.h"
+
+namespace cross_language_match {
+
+DeckWatcher::DeckWatcher(std::string file_path, Deck *deck, uint32_t poll_interval_ms)
+    : file_path_(file_path),
+      deck_(deck),
+      poll_interval_ms_(poll_interval_ms) {
+
+  if (deck_->IsPaged()) {
+    throw std::runtime_error("Only a fully loaded deck can follow its word file");
+  }
+
+  std::vector<HashedPair> pairs_by_line;
+  pairs_by_line.reserve(deck_->GetPairCount());
+  pairs_by_left_word_.reserve(deck_->GetPairCount());
+  pairs_by_right_word_.reserve(deck_->GetPairCount());
+  for (int pair_index = 0; pair_index < deck_->GetPairCount(); pair_index++) {
+    const char *left_word = deck_->GetLeftWord(pair_index);
+    const char *right_word = deck_->GetRightWord(pair_index);
+    pairs_by_line.push_back({HashLine(left_word, right_word), pair_index});
+    pairs_by_left_word_.push_back({Fnv1a64(left_word, strlen(left_word)), pair_index});
+    pairs_by_right_word_.push_back({Fnv1a64(right_word, strlen(right_word)), pair_index});
+  }
+  std::sort(pairs_by_left_word_.begin(), pairs_by_left_word_.end());
+  std::sort(pairs_by_right_word_.begin(), pairs_by_right_word_.end());
+
+  // The file as it is now is the file the deck was built from, so each of its lines is matched to its pair once here
+  HasFileChanged();
+  std::vector<ScannedLine> lines;
+  if (!ScanFile(&lines)) {
+    printf("Unable to read word file %s\n", file_path_.c_str());
+  }
+  for (const ScannedLine &line : lines) {
+    line_hashes_.push_back(line.hash);
+  }
+  line_pairs_.assign(lines.size(), kNoPair);
+  std::vector<bool> vanished(deck_->GetPairCount(), false);
+  std::vector<ScannedLine> unknown_lines;
+  MatchLines(&pairs_by_line, &lines, &line_pairs_, &vanished, &unknown_lines);
+
+}
+
+bool DeckWatcher::Poll(uint32_t now_ms, DeckEdit *edit) {
+
+  if (now_ms - last_poll_ms_ < poll_interval_ms_) {
+    return false;
+  }
+  last_poll_ms_ = now_ms;
+
+  if (!HasFileChanged()) {
+    return false;
+  }
+
+  auto start_time = std::chrono::steady_clock::now();
+
+  if (FileWordLoader(file_path_).DetectCompression() != FileWordLoader::UNCOMPRESSED) {
+    printf("Word file %s is compressed; edits to it are not followed\n", file_path_.c_str());
+    return false;
+  }
+
+  std::vector<ScannedLine> lines;
+  if (!ScanFile(&lines)) {
+    printf("Unable to read word file %s\n", file_path_.c_str());
+    return false;
+  }
+
+  // An edit usually touches one stretch of the file; the lines before and after it are the same lines as before, at
+  // the same distance from either end
+  int old_line_count = (int) line_hashes_.size();
+  int new_line_count = (int) lines.size();
+  int prefix = 0;
+  while (prefix < old_line_count && prefix < new_line_count && lines[prefix].hash == line_hashes_[prefix]) {
+    prefix++;
+  }
+  int suffix = 0;
+  while (suffix < old_line_count - prefix && suffix < new_line_count - prefix
+      && lines[new_line_count - 1 - suffix].hash == line_hashes_[old_line_count - 1 - suffix]) {
+    suffix++;
+  }
+
+  std::vector<int> line_pairs(new_line_count, kNoPair);
+  std::copy(line_pairs_.begin(), line_pairs_.begin() + prefix, line_pairs.begin());
+  std::copy(line_pairs_.end() - suffix, line_pairs_.end(), line_pairs.end() - suffix);
+
+  // Within the stretch, lines that were only moved are still matched to their pairs by hash
+  std::vector<HashedPair> known_pairs;
+  for (int i = prefix; i < old_line_count - suffix; i++) {
+    if (line_pairs_[i] != kNoPair) {
+      known_pairs.push_back({line_hashes_[i], line_pairs_[i]});
+    }
+  }
+  std::vector<ScannedLine> middle_lines(lines.begin() + prefix, lines.end() - suffix);
+  std::vector<bool> vanished(deck_->GetPairCount(), false);
+  std::vector<ScannedLine> unknown_lines;
+  MatchLines(&known_pairs, &middle_lines, &line_pairs, &vanished, &unknown_lines);
+
+  // A line repeating a left word is ignored while an earlier line holds the word; once that line is gone, the repeat
+  // may be next in line for it
+  if (std::find(vanished.begin(), vanished.end(), true) != vanished.end()) {
+    for (int i = 0; i < new_line_count; i++) {
+      if (line_pairs[i] == kNoPair && (i < prefix || i >= new_line_count - suffix)) {
+        unknown_lines.push_back(lines[i]);
+      }
+    }
+  }
+
+  // Back in file order, since the first line with a given left word is the one that counts
+  std::sort(unknown_lines.begin(), unknown_lines.end(), [](const ScannedLine &a, const ScannedLine &b) {
+    return a.line_index < b.line_index;
+  });
+  std::vector<std::string> line_texts;
+  if (!ReadLines(unknown_lines, &line_texts)) {
+    printf("Unable to read word file %s\n", file_path_.c_str());
+    return false;
+  }
+
+  // Every new line is parsed before anything is applied, so a half-saved file cannot leave the deck half edited
+  std::vector<std::pair<std::string, std::string>> new_pairs(line_texts.size());
+  for (std::size_t i = 0; i < line_texts.size(); i++) {
+    if (WordLoader::SplitLine(line_texts[i], &new_pairs[i].first, &new_pairs[i].second)
+        != WordLoader::InputError::NONE) {
+      printf("Word file %s has a malformed line, \"%s\"; waiting for the next change\n",
+             file_path_.c_str(),
+             line_texts[i].c_str());
+      return false;
+    }
+  }
+
+  edit->added_pairs.clear();
+  edit->changed_pairs.clear();
+  edit->removed_pairs.clear();
+  std::vector<HashedPair> left_word_additions;
+  std::vector<HashedPair> right_word_additions;
+  // The lookups only see the pairs from before this edit, so words the edit has already used are tracked here
+  std::set<std::string> added_left_words;
+  std::map<std::string, int> edited_right_words;
+  for (std::size_t i = 0; i < new_pairs.size(); i++) {
+
+    const std::string &left_word = new_pairs[i].first;
+    const std::string &right_word = new_pairs[i].second;
+    int pair_index = FindPairByLeftWord(left_word);
+    if (pair_index == kNoPair ? !added_left_words.insert(left_word).second : !vanished[pair_index]) {
+      continue;
+    }
+
+    // A repeated line taking over from an identical one needs no edit
+    if (pair_index == kNoPair || right_word != deck_->GetRightWord(pair_index)) {
+
+      auto edited_right_word = edited_right_words.find(right_word);
+      int right_word_id = edited_right_word == edited_right_words.end()
+          ? FindRightWordId(right_word)
+          : deck_->GetRightWordId(edited_right_word->second);
+
+      if (pair_index == kNoPair) {
+        pair_index = deck_->AddPair(left_word, right_word, Deck::kNewWordId, right_word_id);
+        left_word_additions.push_back({Fnv1a64(left_word.data(), left_word.size()), pair_index});
+        vanished.push_back(false);
+        edit->added_pairs.push_back(pair_index);
+      } else {
+        deck_->SetRightWord(pair_index, right_word, right_word_id);
+        edit->changed_pairs.push_back(pair_index);
+      }
+
+      right_word_additions.push_back({Fnv1a64(right_word.data(), right_word.size()), pair_index});
+      edited_right_words.emplace(right_word, pair_index);
+
+    }
+
+    vanished[pair_index] = false;
+    line_pairs[unknown_lines[i].line_index] = pair_index;
+
+  }
+
+  for (int pair_index = 0; pair_index < (int) vanished.size(); pair_index++) {
+    if (vanished[pair_index]) {
+      edit->removed_pairs.push_back(pair_index);
+    }
+  }
+
+  // A changed pair keeps its left word entry, but its right word entry is replaced
+  if (!edit->removed_pairs.empty()) {
+    Erase(&pairs_by_left_word_, vanished);
+  }
+  if (!edit->changed_pairs.empty()) {
+    std::vector<bool> changed(vanished.size(), false);
+    for (int pair_index : edit->changed_pairs) {
+      changed[pair_index] = true;
+    }
+    Erase(&pairs_by_right_word_, changed);
+  }
+  Insert(&pairs_by_left_word_, &left_word_additions);
+  Insert(&pairs_by_right_word_, &right_word_additions);
+
+  line_hashes_.resize(lines.size());
+  for (int i = 0; i < new_line_count; i++) {
+    line_hashes_[i] = lines[i].hash;
+  }
+  line_pairs_.swap(line_pairs);
+
+  double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+  printf("Word file changed: %d pairs added, %d changed, %d removed; %d of %d lines unchanged at the ends, %d parsed, "
+         "in %.3f ms\n",
+         (int) edit->added_pairs.size(),
+         (int) edit->changed_pairs.size(),
+         (int) edit->removed_pairs.size(),
+         prefix + suffix,
+         new_line_count,
+         (int) unknown_lines.size(),
+         elapsed_ms);
+  return true;
+
+}
+
+uint64_t DeckWatcher::HashLine(const char *left_word, const char *right_word) {
+  // Hashes the pair exactly as its line reads in the file
+  uint64_t hash = Fnv1a64(left_word, strlen(left_word));
+  hash = Fnv1a64(",", 1, hash);
+  return Fnv1a64(right_word, strlen(right_word), hash);
+}
+
+void DeckWatcher::MatchLines(std::vector<HashedPair> *known_pairs,
+                             std::vector<ScannedLine> *lines,
+                             std::vector<int> *line_pairs,
+                             std::vector<bool> *vanished,
+                             std::vector<ScannedLine> *unknown_lines) {
+
+  // Both sides sorted by hash are matched in a single merge; looking each line up in turn would cost a cache miss per
+  // probe of a table the size of the deck
+  std::sort(known_pairs->begin(), known_pairs->end());
+  std::sort(lines->begin(), lines->end());
+
+  auto line = lines->begin();
+  for (const HashedPair &known_pair : *known_pairs) {
+    for (; line != lines->end() && line->hash < known_pair.hash; line++) {
+      unknown_lines->push_back(*line);
+    }
+    if (line != lines->end() && line->hash == known_pair.hash) {
+      (*line_pairs)[line->line_index] = known_pair.pair_index;
+      line++;
+    } else {
+      (*vanished)[known_pair.pair_index] = true;
+    }
+  }
+  unknown_lines->insert(unknown_lines->end(), line, lines->end());
+
+}
+
+void DeckWatcher::Insert(std::vector<HashedPair> *hashed_pairs, std::vector<HashedPair> *additions) {
+
+  // Merging keeps an edit linear in the deck size, where sorting everything again would not
+  std::sort(additions->begin(), additions->end());
+  std::size_t middle = hashed_pairs->size();
+  hashed_pairs->insert(hashed_pairs->end(), additions->begin(), additions->end());
+  std::inplace_merge(hashed_pairs->begin(), hashed_pairs->begin() + middle, hashed_pairs->end());
+
+}
+
+void DeckWatcher::Erase(std::vector<HashedPair> *hashed_pairs, const std::vector<bool> &erased_pairs) {
+  hashed_pairs->erase(std::remove_if(hashed_pairs->begin(),
+                                     hashed_pairs->end(),
+                                     [&erased_pairs](const HashedPair &hashed_pair) {
+                                       return erased_pairs[hashed_pair.pair_index];
+                                     }),
+                      hashed_pairs->end());
+}
+
+bool DeckWatcher::HasFileChanged() {
+
+  struct stat file_stat;
+  if (stat(file_path_.c_str(), &file_stat) != 0) {
+    return false;
+  }
+
+  int64_t modification_time_ns = (int64_t) file_stat.st_mtim.tv_sec * 1000000000 + file_stat.st_mtim.tv_nsec;
+  if ((uint64_t) file_stat.st_size == file_size_ && modification_time_ns == file_modification_time_ns_) {
+    return false;
+  }
+
+  file_size_ = (uint64_t) file_stat.st_size;
+  file_modification_time_ns_ = modification_time_ns;
+  return true;
+
+}
+
+bool DeckWatcher::ScanFile(std::vector<ScannedLine> *lines) {
+
+  std::ifstream file_stream(file_path_, std::ios::binary);
+  if (!file_stream.is_open()) {
+    return false;
+  }
+
+  // Only hashed here; the few lines that turn out to be new are read again by offset
+  std::string line;
+  uint64_t offset = 0;
+  while (getline(file_stream, line)) {
+    lines->push_back({Fnv1a64(line.data(), line.size()), offset, (uint32_t) line.size(), (int) lines->size()});
+    offset += line.size() + 1;
+  }
+  return true;
+
+}
+
+bool DeckWatcher::ReadLines(const std::vector<ScannedLine> &lines, std::vector<std::string> *line_texts) {
+
+  std::ifstream file_stream(file_path_, std::ios::binary);
+  if (!file_stream.is_open()) {
+    return false;
+  }
+
+  line_texts->resize(lines.size());
+  for (std::size_t i = 0; i < lines.size(); i++) {
+    (*line_texts)[i].resize(lines[i].length);
+    file_stream.seekg((std::streamoff) lines[i].offset);
+    // A line that no longer hashes the same means the file was saved again mid-scan; that save is picked up next poll
+    if (!file_stream.read(&(*line_texts)[i][0], lines[i].length)
+        || Fnv1a64((*line_texts)[i].data(), lines[i].length) != lines[i].hash) {
+      return false;
+    }
+  }
+  return true;
+
+}
+
+int DeckWatcher::FindPairByLeftWord(const std::string &left_word) {
+
+  // Compares the strings as well, since a 64-bit hash is only almost certainly unique
+  uint64_t left_word_hash = Fnv1a64(left_word.data(), left_word.size());
+  auto it = std::lower_bound(pairs_by_left_word_.begin(), pairs_by_left_word_.end(), HashedPair{left_word_hash, 0});
+  for (; it != pairs_by_left_word_.end() && it->hash == left_word_hash; it++) {
+    if (left_word == deck_->GetLeftWord(it->pair_index)) {
+      return it->pair_index;
+    }
+  }
+  return kNoPair;
+
+}
+
+int DeckWatcher::FindRightWordId(const std::string &right_word) {
+
+  uint64_t right_word_hash = Fnv1a64(right_word.data(), right_word.size());
+  auto it = std::lower_bound(pairs_by_right_word_.begin(), pairs_by_right_word_.end(), HashedPair{right_word_hash, 0});
+  for (; it != pairs_by_right_word_.end() && it->hash == right_word_hash; it++) {
+    if (right_word == deck_->GetRightWord(it->pair_index)) {
+      return deck_->GetRightWordId(it->pair_index);
+    }
+  }
+  return Deck::kNewWordId;
+
+}
+
+}
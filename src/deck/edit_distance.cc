@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include "deck/edit_distance.h"
+
+namespace cross_language_match {
+
+static const std::size_t kBitParallelMaxLength = 64;
+
+static int BitParallelEditDistance(const char *pattern,
+                                   std::size_t pattern_length,
+                                   const char *text,
+                                   std::size_t text_length,
+                                   int bound) {
+
+  // Bit i of the mask of a byte is set where the pattern has that byte at position i. Only the pattern's own bytes are
+  // set, and cleared again at the end, so the table is not cleared as a whole on every call; the game is single
+  // threaded, so one table serves every call.
+  static uint64_t byte_masks[256] = {0};
+  for (std::size_t i = 0; i < pattern_length; i++) {
+    byte_masks[(unsigned char) pattern[i]] |= 1ULL << i;
+  }
+
+  // Vertical deltas of the current column, as positive and negative bit vectors; the first column counts up from 0
+  uint64_t positive_vertical = pattern_length == 64 ? ~0ULL : (1ULL << pattern_length) - 1;
+  uint64_t negative_vertical = 0;
+  const uint64_t last_row = 1ULL << (pattern_length - 1);
+  int distance = (int) pattern_length;
+
+  for (std::size_t j = 0; j < text_length; j++) {
+
+    uint64_t matches = byte_masks[(unsigned char) text[j]];
+    uint64_t vertical_changes = matches | negative_vertical;
+    uint64_t horizontal_changes = (((matches & positive_vertical) + positive_vertical) ^ positive_vertical) | matches;
+    uint64_t positive_horizontal = negative_vertical | ~(horizontal_changes | positive_vertical);
+    uint64_t negative_horizontal = positive_vertical & horizontal_changes;
+
+    if (positive_horizontal & last_row) {
+      distance++;
+    } else if (negative_horizontal & last_row) {
+      distance--;
+    }
+
+    // Every remaining byte of the text can lower the distance by at most one
+    if (distance - (int) (text_length - 1 - j) > bound) {
+      distance = bound + 1;
+      break;
+    }
+
+    // The top row of the matrix grows by one per column, hence the carried-in 1
+    positive_horizontal = (positive_horizontal << 1) | 1;
+    negative_horizontal <<= 1;
+    positive_vertical = negative_horizontal | ~(vertical_changes | positive_horizontal);
+    negative_vertical = positive_horizontal & vertical_changes;
+
+  }
+
+  for (std::size_t i = 0; i < pattern_length; i++) {
+    byte_masks[(unsigned char) pattern[i]] = 0;
+  }
+
+  return std::min(distance, bound + 1);
+
+}
+
+static int BandedEditDistance(const char *a, std::size_t a_length, const char *b, std::size_t b_length, int bound) {
+
+  // Only cells within bound of the diagonal can lead to a distance within bound; the rest are treated as over it
+  const int over_bound = bound + 1;
+  std::vector<int> previous_row(b_length + 1);
+  std::vector<int> current_row(b_length + 1);
+  for (std::size_t j = 0; j <= b_length; j++) {
+    previous_row[j] = std::min<int>((int) j, over_bound);
+  }
+
+  for (std::size_t i = 1; i <= a_length; i++) {
+
+    std::size_t first = i > (std::size_t) bound ? i - bound : 1;
+    std::size_t last = std::min(b_length, i + bound);
+    current_row[first - 1] = first == 1 ? std::min<int>((int) i, over_bound) : over_bound;
+    int row_minimum = current_row[first - 1];
+
+    for (std::size_t j = first; j <= last; j++) {
+      int substitution = previous_row[j - 1] + (a[i - 1] == b[j - 1] ? 0 : 1);
+      int deletion = previous_row[j] + 1;
+      int insertion = current_row[j - 1] + 1;
+      current_row[j] = std::min(std::min(substitution, deletion), std::min(insertion, over_bound));
+      row_minimum = std::min(row_minimum, current_row[j]);
+    }
+    if (last < b_length) {
+      current_row[last + 1] = over_bound;
+    }
+
+    if (row_minimum > bound) {
+      return over_bound;
+    }
+    std::swap(previous_row, current_row);
+
+  }
+
+  return previous_row[b_length];
+
+}
+
+int BoundedEditDistance(const char *a, std::size_t a_length, const char *b, std::size_t b_length, int bound) {
+
+  if (std::abs((long) a_length - (long) b_length) > bound) {
+    return bound + 1;
+  }
+  if (a_length == 0 || b_length == 0) {
+    return (int) std::max(a_length, b_length);
+  }
+
+  // The bit vectors run along the shorter string
+  if (a_length > b_length) {
+    std::swap(a, b);
+    std::swap(a_length, b_length);
+  }
+  if (a_length <= kBitParallelMaxLength) {
+    return BitParallelEditDistance(a, a_length, b, b_length, bound);
+  }
+  return BandedEditDistance(a, a_length, b, b_length, bound);
+
+}
+
+}
@@ -0,0 +1,264 @@
+#include <algorithm>
+#include <cstdio>
+#include "deck/leitner_scheduler.h"
+#include "storage/binary_io.h"
+
+namespace cross_language_match {
+
+LeitnerScheduler::LeitnerScheduler(Deck *deck, int retirement_box)
+    : deck_(deck),
+      retirement_box_(retirement_box),
+      states_(deck->GetPairCount(), UNSEEN),
+      boxes_(deck->GetPairCount(), 0),
+      due_rounds_(deck->GetPairCount(), 0),
+      error_counts_(deck->GetPairCount(), 0) {}
+
+int LeitnerScheduler::SelectRound(int count, std::vector<int> *pair_indices) {
+
+  current_round_++;
+  std::size_t first_selected = pair_indices->size();
+
+  // Reviews that have come due take priority, then never-seen pairs; if both run dry the round is topped up with
+  // the reviews due soonest, so rounds stay full towards the end of the game
+  while ((int) (pair_indices->size() - first_selected) < count && ReviewIsDue()) {
+    pair_indices->push_back(PopReview());
+  }
+
+  std::size_t first_drawn = pair_indices->size();
+  int missing = count - (int) (pair_indices->size() - first_selected);
+  if (similarity_index_ != nullptr) {
+    DrawSimilarPairs(missing, pair_indices);
+  } else {
+    DrawPairs(missing, pair_indices);
+  }
+  if (historical_error_source_) {
+    for (std::size_t i = first_drawn; i < pair_indices->size(); i++) {
+      AddHistoricalErrors((*pair_indices)[i], historical_error_source_((*pair_indices)[i]));
+    }
+  }
+
+  while ((int) (pair_indices->size() - first_selected) < count && HasReview()) {
+    pair_indices->push_back(PopReview());
+  }
+
+  for (std::size_t i = first_selected; i < pair_indices->size(); i++) {
+    states_[(*pair_indices)[i]] = IN_ROUND;
+  }
+
+  return (int) (pair_indices->size() - first_selected);
+
+}
+
+void LeitnerScheduler::RecordResult(int pair_index, int error_count) {
+
+  if (states_[pair_index] != IN_ROUND) {
+    return;
+  }
+
+  if (error_count > 0) {
+    AddHistoricalErrors(pair_index, error_count);
+    boxes_[pair_index] = 0;
+    Schedule(pair_index, current_round_ + 1);
+    return;
+  }
+
+  boxes_[pair_index]++;
+  if (boxes_[pair_index] >= retirement_box_) {
+    states_[pair_index] = RETIRED;
+    retired_count_++;
+    return;
+  }
+
+  Schedule(pair_index, current_round_ + (1 << boxes_[pair_index]));
+
+}
+
+void LeitnerScheduler::AddHistoricalErrors(int pair_index, int error_count) {
+  error_counts_[pair_index] = (uint16_t) std::min<int>(error_counts_[pair_index] + error_count, UINT16_MAX);
+}
+
+void LeitnerScheduler::SetHistoricalErrorSource(std::function<int(int pair_index)> historical_error_source) {
+  historical_error_source_ = historical_error_source;
+}
+
+void LeitnerScheduler::SetSimilarityIndex(SimilarityIndex *similarity_index) {
+  similarity_index_ = similarity_index;
+}
+
+void LeitnerScheduler::AddPair() {
+  states_.push_back(UNSEEN);
+  boxes_.push_back(0);
+  due_rounds_.push_back(0);
+  error_counts_.push_back(0);
+}
+
+void LeitnerScheduler::RemovePair(int pair_index) {
+
+  if (states_[pair_index] == RETIRED) {
+    return;
+  }
+
+  // A scheduled pair stays in the heap until it comes up; HasReview discards it then
+  states_[pair_index] = RETIRED;
+  retired_count_++;
+
+}
+
+bool LeitnerScheduler::IsComplete() {
+  return retired_count_ == (int) states_.size();
+}
+
+int LeitnerScheduler::GetCurrentRound() {
+  return current_round_;
+}
+
+int LeitnerScheduler::GetReviewCount() {
+  return (int) review_heap_.size();
+}
+
+bool LeitnerScheduler::WriteState(FILE *file) {
+
+  return WriteValue(file, current_round_)
+      && WriteValue(file, retired_count_)
+      && WriteVector(file, states_)
+      && WriteVector(file, boxes_)
+      && WriteVector(file, due_rounds_)
+      && WriteVector(file, error_counts_)
+      && WriteVector(file, review_heap_);
+
+}
+
+bool LeitnerScheduler::ReadState(FILE *file) {
+
+  std::size_t pair_count = states_.size();
+  int current_round = 0;
+  int retired_count = 0;
+  std::vector<PairState> states;
+  std::vector<uint8_t> boxes;
+  std::vector<int32_t> due_rounds;
+  std::vector<uint16_t> error_counts;
+  std::vector<int> review_heap;
+
+  bool read = ReadValue(file, &current_round)
+      && ReadValue(file, &retired_count)
+      && ReadVector(file, &states, pair_count)
+      && ReadVector(file, &boxes, pair_count)
+      && ReadVector(file, &due_rounds, pair_count)
+      && ReadVector(file, &error_counts, pair_count)
+      && ReadVector(file, &review_heap, pair_count)
+      && states.size() == pair_count
+      && boxes.size() == pair_count
+      && due_rounds.size() == pair_count
+      && error_counts.size() == pair_count;
+  if (!read) {
+    return false;
+  }
+  for (int pair_index : review_heap) {
+    if (pair_index < 0 || pair_index >= (int) pair_count) {
+      return false;
+    }
+  }
+
+  current_round_ = current_round;
+  retired_count_ = retired_count;
+  states_.swap(states);
+  boxes_.swap(boxes);
+  due_rounds_.swap(due_rounds);
+  error_counts_.swap(error_counts);
+  review_heap_.swap(review_heap);
+  return true;
+
+}
+
+void LeitnerScheduler::DrawPairs(int count, std::vector<int> *pair_indices) {
+
+  // Pairs removed from the deck before being drawn are still in its draw order; they are dropped and replaced here
+  std::size_t first_drawn = pair_indices->size();
+  int missing = count;
+  while (missing > 0 && deck_->Draw(missing, pair_indices) > 0) {
+    pair_indices->erase(std::remove_if(pair_indices->begin() + first_drawn,
+                                       pair_indices->end(),
+                                       [this](int pair_index) { return states_[pair_index] == RETIRED; }),
+                        pair_indices->end());
+    missing = count - (int) (pair_indices->size() - first_drawn);
+  }
+
+}
+
+void LeitnerScheduler::DrawSimilarPairs(int count, std::vector<int> *pair_indices) {
+
+  std::size_t first_drawn = pair_indices->size();
+  std::vector<int> neighbours;
+  while ((int) (pair_indices->size() - first_drawn) < count && deck_->Draw(1, pair_indices) > 0) {
+
+    int seed_pair = pair_indices->back();
+    if (states_[seed_pair] == RETIRED) {
+      pair_indices->pop_back();
+      continue;
+    }
+
+    // Neighbours already drawn, or retired before being drawn, are left where they are
+    neighbours.clear();
+    similarity_index_->GetNeighbours(seed_pair, &neighbours);
+    for (std::size_t i = 0; i < neighbours.size() && (int) (pair_indices->size() - first_drawn) < count; i++) {
+      if (states_[neighbours[i]] == UNSEEN && deck_->DrawPair(neighbours[i])) {
+        pair_indices->push_back(neighbours[i]);
+      }
+    }
+
+  }
+
+}
+
+void LeitnerScheduler::Schedule(int pair_index, int due_round) {
+
+  states_[pair_index] = SCHEDULED;
+  due_rounds_[pair_index] = due_round;
+
+  review_heap_.push_back(pair_index);
+  std::push_heap(review_heap_.begin(), review_heap_.end(), [this](int a, int b) {
+    return IsReviewedAfter(a, b);
+  });
+
+}
+
+int LeitnerScheduler::PopReview() {
+
+  std::pop_heap(review_heap_.begin(), review_heap_.end(), [this](int a, int b) {
+    return IsReviewedAfter(a, b);
+  });
+  int pair_index = review_heap_.back();
+  review_heap_.pop_back();
+  return pair_index;
+
+}
+
+bool LeitnerScheduler::HasReview() {
+
+  // Only removed pairs can be in the heap without being scheduled
+  while (!review_heap_.empty() && states_[review_heap_.front()] != SCHEDULED) {
+    PopReview();
+  }
+  return !review_heap_.empty();
+
+}
+
+bool LeitnerScheduler::ReviewIsDue() {
+  return HasReview() && due_rounds_[review_heap_.front()] <= current_round_;
+}
+
+bool LeitnerScheduler::IsReviewedAfter(int pair_index, int other_pair_index) {
+
+  if (due_rounds_[pair_index] != due_rounds_[other_pair_index]) {
+    return due_rounds_[pair_index] > due_rounds_[other_pair_index];
+  }
+
+  if (error_counts_[pair_index] != error_counts_[other_pair_index]) {
+    return error_counts_[pair_index] < error_counts_[other_pair_index];
+  }
+
+  return pair_index > other_pair_index;
+
+}
+
+}
@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <utility>
+#include "deck/similarity_index.h"
+#include "deck/edit_distance.h"
+
+namespace cross_language_match {
+
+// Two rows per band suits short words: lugar and llegar share 4 of their 9 bigrams, and signatures of words that
+// similar meet in at least one of 16 bands about 97% of the time
+static const int kBandCount = 16;
+static const int kRowsPerBand = 2;
+static const int kSignatureLength = kBandCount * kRowsPerBand;
+// Larger buckets are mostly words sharing common bigrams by chance; each member is only compared with the next few
+static const int kMaxBucketComparisons = 4;
+// Fixed, so that the same deck always gets the same index
+static const uint64_t kHashFamilySeed = 0x5EED5EED5EED5EEDULL;
+static const unsigned char kWordStart = 0x02;
+static const unsigned char kWordEnd = 0x03;
+
+static uint64_t MixBits(uint64_t value) {
+  value ^= value >> 33;
+  value *= 0xFF51AFD7ED558CCDULL;
+  value ^= value >> 33;
+  value *= 0xC4CEB9FE1A85EC53ULL;
+  return value ^ (value >> 33);
+}
+
+static void ComputeSignature(const std::string &word,
+                             const uint64_t *multipliers,
+                             const uint64_t *offsets,
+                             uint32_t *signature) {
+
+  std::fill(signature, signature + kSignatureLength, UINT32_MAX);
+
+  // Bigrams include the word's boundaries, so that words sharing a beginning or an ending are drawn together
+  unsigned char previous = kWordStart;
+  for (std::size_t i = 0; i <= word.size(); i++) {
+    unsigned char current = i < word.size() ? (unsigned char) word[i] : kWordEnd;
+    uint64_t bigram_hash = MixBits(((uint64_t) previous << 8) | current);
+    for (int row = 0; row < kSignatureLength; row++) {
+      signature[row] = std::min(signature[row], (uint32_t) ((bigram_hash * multipliers[row] + offsets[row]) >> 32));
+    }
+    previous = current;
+  }
+
+}
+
+// Counting sort of (pair, value) entries by pair: the values of pair i end up at [offsets[i], offsets[i + 1])
+template<typename Value>
+static void GroupByPair(int pair_count,
+                        const std::vector<std::pair<int, Value>> &entries,
+                        std::vector<int> *offsets,
+                        std::vector<Value> *values) {
+
+  offsets->assign(pair_count + 1, 0);
+  for (auto &entry : entries) {
+    (*offsets)[entry.first + 1]++;
+  }
+  for (int pair_index = 0; pair_index < pair_count; pair_index++) {
+    (*offsets)[pair_index + 1] += (*offsets)[pair_index];
+  }
+
+  std::vector<int> cursors(offsets->begin(), offsets->end() - 1);
+  values->resize(entries.size());
+  for (auto &entry : entries) {
+    (*values)[cursors[entry.first]++] = entry.second;
+  }
+
+}
+
+static int GetDistanceBound(std::size_t a_length, std::size_t b_length) {
+  return std::max<int>(1, ((int) std::min(a_length, b_length) + 1) / 3);
+}
+
+SimilarityIndex::SimilarityIndex(Deck *deck) {
+
+  auto start_time = std::chrono::steady_clock::now();
+  int pair_count = deck->GetPairCount();
+
+  std::vector<std::string> words(pair_count);
+  for (int pair_index = 0; pair_index < pair_count; pair_index++) {
+    words[pair_index] = deck->GetLeftWord(pair_index);
+    for (char &character : words[pair_index]) {
+      character = (char) tolower((unsigned char) character);
+    }
+  }
+
+  uint64_t multipliers[kSignatureLength];
+  uint64_t offsets[kSignatureLength];
+  std::mt19937_64 hash_family_engine(kHashFamilySeed);
+  for (int row = 0; row < kSignatureLength; row++) {
+    multipliers[row] = hash_family_engine() | 1;
+    offsets[row] = hash_family_engine();
+  }
+
+  std::vector<uint32_t> signatures((std::size_t) pair_count * kSignatureLength);
+  for (int pair_index = 0; pair_index < pair_count; pair_index++) {
+    ComputeSignature(words[pair_index], multipliers, offsets, &signatures[(std::size_t) pair_index * kSignatureLength]);
+  }
+
+  // Each band buckets the words by its rows; sorting by bucket key brings every bucket together
+  std::vector<std::pair<int, int>> candidates;
+  std::vector<std::pair<uint64_t, int>> bucket_keys(pair_count);
+  for (int band = 0; band < kBandCount; band++) {
+
+    for (int pair_index = 0; pair_index < pair_count; pair_index++) {
+      const uint32_t *rows = &signatures[(std::size_t) pair_index * kSignatureLength + band * kRowsPerBand];
+      bucket_keys[pair_index] = {((uint64_t) rows[0] << 32) | rows[1], pair_index};
+    }
+    std::sort(bucket_keys.begin(), bucket_keys.end());
+
+    for (int i = 0; i < pair_count; i++) {
+      for (int j = i + 1; j < pair_count && j <= i + kMaxBucketComparisons; j++) {
+        if (bucket_keys[j].first != bucket_keys[i].first) {
+          break;
+        }
+        candidates.emplace_back(std::min(bucket_keys[i].second, bucket_keys[j].second),
+                                std::max(bucket_keys[i].second, bucket_keys[j].second));
+      }
+    }
+
+  }
+  std::vector<uint32_t>().swap(signatures);
+
+  // Candidates are grouped by word with a counting sort, which stays linear where sorting them all would not; each
+  // word's own list is short, so duplicates from words sharing several bands are cheap to drop there
+  std::vector<int> candidate_offsets;
+  std::vector<int> candidate_partners;
+  GroupByPair(pair_count, candidates, &candidate_offsets, &candidate_partners);
+  int candidate_count = (int) candidates.size();
+  std::vector<std::pair<int, int>>().swap(candidates);
+
+  // Similar words as (word, (distance, other word)), so that sorting a word's list puts the nearest first
+  std::vector<std::pair<int, std::pair<int, int>>> similar_words;
+  int compared_count = 0;
+  for (int pair_index = 0; pair_index < pair_count; pair_index++) {
+
+    auto first = candidate_partners.begin() + candidate_offsets[pair_index];
+    auto last = candidate_partners.begin() + candidate_offsets[pair_index + 1];
+    std::sort(first, last);
+    last = std::unique(first, last);
+
+    const std::string &word = words[pair_index];
+    for (auto partner = first; partner != last; partner++) {
+      const std::string &other_word = words[*partner];
+      int bound = GetDistanceBound(word.size(), other_word.size());
+      int distance = BoundedEditDistance(word.data(), word.size(), other_word.data(), other_word.size(), bound);
+      if (distance <= bound) {
+        similar_words.push_back({pair_index, {distance, *partner}});
+        similar_words.push_back({*partner, {distance, pair_index}});
+      }
+      compared_count++;
+    }
+
+  }
+
+  std::vector<int> similar_offsets;
+  std::vector<std::pair<int, int>> ranked_similar_words;
+  GroupByPair(pair_count, similar_words, &similar_offsets, &ranked_similar_words);
+
+  neighbour_offsets_.assign(pair_count + 1, 0);
+  for (int pair_index = 0; pair_index < pair_count; pair_index++) {
+    auto first = ranked_similar_words.begin() + similar_offsets[pair_index];
+    auto last = ranked_similar_words.begin() + similar_offsets[pair_index + 1];
+    auto kept = first + std::min<int>((int) (last - first), kMaxNeighbours);
+    std::partial_sort(first, kept, last);
+    for (auto similar_word = first; similar_word != kept; similar_word++) {
+      neighbours_.push_back(similar_word->second);
+    }
+    neighbour_offsets_[pair_index + 1] = (int) neighbours_.size();
+  }
+  neighbours_.shrink_to_fit();
+
+  double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+  printf("Similarity index over %d words: %d candidates, %d compared, %d similar words kept, %d KB, built in %.1f ms\n",
+         pair_count,
+         candidate_count,
+         compared_count,
+         (int) neighbours_.size(),
+         (int) (GetMemoryBytes() / 1024),
+         elapsed_ms);
+
+}
+
+void SimilarityIndex::GetNeighbours(int pair_index, std::vector<int> *neighbours) {
+  if (pair_index + 1 >= (int) neighbour_offsets_.size()) {
+    return;
+  }
+  neighbours->insert(neighbours->end(),
+                     neighbours_.begin() + neighbour_offsets_[pair_index],
+                     neighbours_.begin() + neighbour_offsets_[pair_index + 1]);
+}
+
+std::size_t SimilarityIndex::GetMemoryBytes() {
+  return (neighbour_offsets_.capacity() + neighbours_.capacity()) * sizeof(int);
+}
+
+}
@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include "deck/word_trie.h"
+
+namespace cross_language_match {
+
+static const uint32_t kMaxLabelLength = UINT16_MAX;
+
+WordTrie::WordTrie(Deck *deck) {
+
+  auto start_time = std::chrono::steady_clock::now();
+
+  std::vector<std::string> words;
+  words.reserve(deck->GetPairCount());
+  for (int pair_index = 0; pair_index < deck->GetPairCount(); pair_index++) {
+    words.emplace_back(deck->GetRightWord(pair_index));
+  }
+  std::sort(words.begin(), words.end());
+  words.erase(std::unique(words.begin(), words.end()), words.end());
+
+  word_offsets_.reserve(words.size() + 1);
+  for (auto &word : words) {
+    word_offsets_.push_back((uint32_t) characters_.size());
+    characters_.insert(characters_.end(), word.begin(), word.end());
+    characters_.push_back('\0');
+  }
+  word_offsets_.push_back((uint32_t) characters_.size());
+  std::vector<std::string>().swap(words);
+
+  struct PendingNode {
+    uint32_t node;
+    // Length of the prefix that ends with this node's label, shared by all of its words
+    uint32_t depth;
+  };
+
+  label_offsets_.push_back(0);
+  label_lengths_.push_back(0);
+  child_counts_.push_back(0);
+  first_children_.push_back(0);
+  first_words_.push_back(0);
+  end_words_.push_back((uint32_t) GetWordCount());
+
+  // Breadth first, so that all children of a node are created together and end up next to each other
+  std::vector<PendingNode> pending_nodes = {{0, 0}};
+  for (std::size_t next = 0; next < pending_nodes.size(); next++) {
+
+    PendingNode pending = pending_nodes[next];
+    uint32_t word_index = first_words_[pending.node];
+    uint32_t end_word = end_words_[pending.node];
+    first_children_[pending.node] = (uint32_t) label_offsets_.size();
+
+    // Sorting puts the word that ends at this node, if there is one, before every longer word sharing its prefix
+    if (word_index < end_word && GetWordLength(word_index) == pending.depth) {
+      word_index++;
+    }
+
+    while (word_index < end_word) {
+
+      char first_byte = characters_[word_offsets_[word_index] + pending.depth];
+      uint32_t group_end = word_index + 1;
+      while (group_end < end_word && characters_[word_offsets_[group_end] + pending.depth] == first_byte) {
+        group_end++;
+      }
+
+      // Within a sorted group, the prefix shared by the first and last words is shared by all of them
+      const char *first_word = &characters_[word_offsets_[word_index]];
+      const char *last_word = &characters_[word_offsets_[group_end - 1]];
+      uint32_t shared_length = pending.depth + 1;
+      uint32_t shortest_length = std::min(GetWordLength(word_index), GetWordLength(group_end - 1));
+      while (shared_length < shortest_length && first_word[shared_length] == last_word[shared_length]) {
+        shared_length++;
+      }
+
+      // Longer labels are split into a chain of nodes, each with a single child
+      uint32_t label_length = std::min(shared_length - pending.depth, kMaxLabelLength);
+      uint32_t child = (uint32_t) label_offsets_.size();
+      label_offsets_.push_back(word_offsets_[word_index] + pending.depth);
+      label_lengths_.push_back((uint16_t) label_length);
+      child_counts_.push_back(0);
+      first_children_.push_back(0);
+      first_words_.push_back(word_index);
+      end_words_.push_back(group_end);
+      child_counts_[pending.node]++;
+      pending_nodes.push_back({child, pending.depth + label_length});
+
+      word_index = group_end;
+
+    }
+
+  }
+
+  label_offsets_.shrink_to_fit();
+  label_lengths_.shrink_to_fit();
+  child_counts_.shrink_to_fit();
+  first_children_.shrink_to_fit();
+  first_words_.shrink_to_fit();
+  end_words_.shrink_to_fit();
+
+  double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+  printf("Word trie over %d words: %d nodes, %d KB, built in %.1f ms\n",
+         GetWordCount(),
+         (int) label_offsets_.size(),
+         (int) (GetMemoryBytes() / 1024),
+         elapsed_ms);
+
+}
+
+WordTrie::Position WordTrie::GetRootPosition() {
+  return {0, 0};
+}
+
+bool WordTrie::Advance(Position *position, char character) {
+
+  uint32_t node = position->node;
+  if (position->label_bytes_matched < label_lengths_[node]) {
+    if (characters_[label_offsets_[node] + position->label_bytes_matched] != character) {
+      return false;
+    }
+    position->label_bytes_matched++;
+    return true;
+  }
+
+  // At most one child per byte value, so this scan is bounded by the alphabet rather than the deck
+  uint32_t end_child = first_children_[node] + child_counts_[node];
+  for (uint32_t child = first_children_[node]; child < end_child; child++) {
+    if (characters_[label_offsets_[child]] == character) {
+      position->node = child;
+      position->label_bytes_matched = 1;
+      return true;
+    }
+  }
+  return false;
+
+}
+
+int WordTrie::GetCompletionCount(const Position &position) {
+  return (int) (end_words_[position.node] - first_words_[position.node]);
+}
+
+int WordTrie::GetCompletions(const Position &position, int max_count, int *word_indices) {
+
+  int count = std::min(GetCompletionCount(position), max_count);
+  for (int i = 0; i < count; i++) {
+    word_indices[i] = (int) first_words_[position.node] + i;
+  }
+  return count;
+
+}
+
+int WordTrie::GetWordCount() {
+  return (int) word_offsets_.size() - 1;
+}
+
+const char *WordTrie::GetWord(int word_index) {
+  return &characters_[word_offsets_[word_index]];
+}
+
+int WordTrie::GetMaxWordLength() {
+
+  uint32_t max_word_length = 0;
+  for (uint32_t word_index = 0; word_index < (uint32_t) GetWordCount(); word_index++) {
+    max_word_length = std::max(max_word_length, GetWordLength(word_index));
+  }
+  return (int) max_word_length;
+
+}
+
+uint32_t WordTrie::GetWordLength(uint32_t word_index) {
+  return word_offsets_[word_index + 1] - word_offsets_[word_index] - 1;
+}
+
+std::size_t WordTrie::GetMemoryBytes() {
+  return characters_.capacity()
+      + (word_offsets_.capacity() + label_offsets_.capacity() + first_children_.capacity()
+          + first_words_.capacity() + end_words_.capacity()) * sizeof(uint32_t)
+      + (label_lengths_.capacity() + child_counts_.capacity()) * sizeof(uint16_t);
+}
+
+}
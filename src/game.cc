@@ -1,13 +1,18 @@
 #include <SDL2/SDL.h>
+#include <emscripten.h>
 #include <boost/format.hpp>
 #include <scene/start_scene.h>
 #include "game.h"
 #include "scene/game_scene.h"
+#include "scene/scene_manager.h"
+#include "storage/persistent_storage.h"
 
 namespace cross_language_match {
 
 Game::Game() {
 
+  printf("Game started %.1f ms after the page began loading\n", emscripten_get_now());
+
   if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0) {
     throw std::runtime_error(
         boost::str(boost::format("SDL could not initialize, error: %1%\n") % SDL_GetError())
@@ -17,9 +22,9 @@ Game::Game() {
   window_ = SDL_CreateWindow("Cross Language Match",
                              SDL_WINDOWPOS_UNDEFINED,
                              SDL_WINDOWPOS_UNDEFINED,
-                             screen_width_,
-                             screen_height_,
-                             SDL_WINDOW_SHOWN);
+                             initial_screen_width_,
+                             initial_screen_height_,
+                             SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI);
 
   if (window_ == nullptr) {
     throw std::runtime_error(
@@ -34,11 +39,21 @@ Game::Game() {
         boost::str(boost::format("Renderer could not be created, error: %1%\n") % SDL_GetError())
     );
   }
+  Scene::UpdatePixelScale(renderer_, window_);
+
+  // Nothing is fetched yet; the first scene asks for the assets it needs
+  asset_bundle_ = new AssetBundle(kAssetBundleUrl);
+  font_cache_ = new FontCache(asset_bundle_);
 
 }
 
 Game::~Game() {
 
+  delete font_cache_;
+  font_cache_ = nullptr;
+  delete asset_bundle_;
+  asset_bundle_ = nullptr;
+
   SDL_DestroyWindow(window_);
   window_ = nullptr;
   SDL_Quit();
@@ -47,9 +62,14 @@ Game::~Game() {
 
 void Game::Run() {
 
-  StartScene start_scene = StartScene(renderer_, window_, global_quit_,
-                                      (int) screen_height_, (int) screen_width_);
-  start_scene.Run();
+  SceneManager scene_manager(global_quit_);
+
+  // The start scene fetches the font for its title as it is built, before persistent storage holds up anything else
+  StartScene *start_scene =
+      new StartScene(renderer_, window_, global_quit_, font_cache_);
+  MountPersistentStorage();
+  scene_manager.Push(start_scene);
+  scene_manager.Run();
 
 }
 
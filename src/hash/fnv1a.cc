@@ -0,0 +1,20 @@
+#include "hash/fnv1a.h"
+
+namespace cross_language_match {
+
+uint64_t Fnv1a64(const void *data, std::size_t length, uint64_t basis) {
+
+  const uint64_t prime = 0x100000001B3ULL;
+  const unsigned char *bytes = static_cast<const unsigned char *>(data);
+
+  uint64_t hash = basis;
+  for (std::size_t i = 0; i < length; i++) {
+    hash ^= bytes[i];
+    hash *= prime;
+  }
+
+  return hash;
+
+}
+
+}
@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <cstring>
+#include "hash/xxhash64.h"
+
+namespace cross_language_match {
+
+static const uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+static const uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+static uint64_t RotateLeft(uint64_t value, int bits) {
+  return (value << bits) | (value >> (64 - bits));
+}
+
+// Both the browser and the usual native targets are little-endian, which is the byte order xxHash is defined in
+static uint64_t Read64(const unsigned char *bytes) {
+  uint64_t value;
+  memcpy(&value, bytes, sizeof(value));
+  return value;
+}
+
+static uint32_t Read32(const unsigned char *bytes) {
+  uint32_t value;
+  memcpy(&value, bytes, sizeof(value));
+  return value;
+}
+
+static uint64_t Round(uint64_t accumulator, uint64_t input) {
+  accumulator += input * kPrime2;
+  accumulator = RotateLeft(accumulator, 31);
+  return accumulator * kPrime1;
+}
+
+static uint64_t MergeRound(uint64_t hash, uint64_t accumulator) {
+  hash ^= Round(0, accumulator);
+  return hash * kPrime1 + kPrime4;
+}
+
+uint64_t XxHash64(const void *data, std::size_t length, uint64_t seed) {
+
+  XxHash64State state(seed);
+  state.Update(data, length);
+  return state.Digest();
+
+}
+
+XxHash64State::XxHash64State(uint64_t seed)
+    : seed_(seed),
+      // Four independent lanes, so consecutive rounds do not wait on each other
+      accumulator_1_(seed + kPrime1 + kPrime2),
+      accumulator_2_(seed + kPrime2),
+      accumulator_3_(seed),
+      accumulator_4_(seed - kPrime1) {
+}
+
+void XxHash64State::Update(const void *data, std::size_t length) {
+
+  const unsigned char *bytes = static_cast<const unsigned char *>(data);
+  const unsigned char *end = bytes + length;
+  total_length_ += length;
+  if (length == 0) {
+    return;
+  }
+
+  // Top up a stripe left over from the previous call first
+  if (pending_length_ > 0) {
+    std::size_t copy_length = std::min(sizeof(pending_) - pending_length_, length);
+    memcpy(pending_ + pending_length_, bytes, copy_length);
+    pending_length_ += copy_length;
+    bytes += copy_length;
+    if (pending_length_ < sizeof(pending_)) {
+      return;
+    }
+    accumulator_1_ = Round(accumulator_1_, Read64(pending_));
+    accumulator_2_ = Round(accumulator_2_, Read64(pending_ + 8));
+    accumulator_3_ = Round(accumulator_3_, Read64(pending_ + 16));
+    accumulator_4_ = Round(accumulator_4_, Read64(pending_ + 24));
+    pending_length_ = 0;
+  }
+
+  while (end - bytes >= 32) {
+    accumulator_1_ = Round(accumulator_1_, Read64(bytes));
+    accumulator_2_ = Round(accumulator_2_, Read64(bytes + 8));
+    accumulator_3_ = Round(accumulator_3_, Read64(bytes + 16));
+    accumulator_4_ = Round(accumulator_4_, Read64(bytes + 24));
+    bytes += 32;
+  }
+
+  memcpy(pending_, bytes, end - bytes);
+  pending_length_ = end - bytes;
+
+}
+
+uint64_t XxHash64State::Digest() const {
+
+  uint64_t hash;
+  if (total_length_ >= 32) {
+    hash = RotateLeft(accumulator_1_, 1) + RotateLeft(accumulator_2_, 7)
+        + RotateLeft(accumulator_3_, 12) + RotateLeft(accumulator_4_, 18);
+    hash = MergeRound(hash, accumulator_1_);
+    hash = MergeRound(hash, accumulator_2_);
+    hash = MergeRound(hash, accumulator_3_);
+    hash = MergeRound(hash, accumulator_4_);
+  } else {
+    hash = seed_ + kPrime5;
+  }
+
+  hash += total_length_;
+
+  const unsigned char *bytes = pending_;
+  const unsigned char *end = pending_ + pending_length_;
+
+  while (bytes + 8 <= end) {
+    hash ^= Round(0, Read64(bytes));
+    hash = RotateLeft(hash, 27) * kPrime1 + kPrime4;
+    bytes += 8;
+  }
+
+  if (bytes + 4 <= end) {
+    hash ^= (uint64_t) Read32(bytes) * kPrime1;
+    hash = RotateLeft(hash, 23) * kPrime2 + kPrime3;
+    bytes += 4;
+  }
+
+  while (bytes < end) {
+    hash ^= (*bytes) * kPrime5;
+    hash = RotateLeft(hash, 11) * kPrime1;
+    bytes++;
+  }
+
+  hash ^= hash >> 33;
+  hash *= kPrime2;
+  hash ^= hash >> 29;
+  hash *= kPrime3;
+  hash ^= hash >> 32;
+
+  return hash;
+
+}
+
+}
@@ -0,0 +1,70 @@
+#include <algorithm>
+#include "memory/round_arena.h"
+
+namespace cross_language_match {
+
+RoundArena::RoundArena(std::size_t block_size) : block_size_(block_size) {}
+
+RoundArena::~RoundArena() {
+
+  Release();
+
+  for (auto &block : blocks_) {
+    delete[] block.memory;
+  }
+  blocks_.clear();
+
+}
+
+void RoundArena::Release() {
+
+  for (auto destructor = destructors_.rbegin(); destructor != destructors_.rend(); destructor++) {
+    destructor->destroy(destructor->object);
+  }
+  destructors_.clear();
+
+  current_block_ = 0;
+  current_offset_ = 0;
+  allocation_count_ = 0;
+  new_block_count_ = 0;
+
+}
+
+int RoundArena::GetAllocationCount() {
+  return allocation_count_;
+}
+
+int RoundArena::GetNewBlockCount() {
+  return new_block_count_;
+}
+
+void *RoundArena::Allocate(std::size_t size, std::size_t alignment) {
+
+  while (current_block_ < blocks_.size()) {
+
+    Block &block = blocks_[current_block_];
+    std::size_t aligned_offset = (current_offset_ + alignment - 1) / alignment * alignment;
+
+    if (aligned_offset + size <= block.size) {
+      current_offset_ = aligned_offset + size;
+      return block.memory + aligned_offset;
+    }
+
+    current_block_++;
+    current_offset_ = 0;
+
+  }
+
+  // No retained block has room; grab a new one large enough for this request. Blocks come from operator new[], which
+  // is aligned for any fundamental type, so offset zero needs no adjustment.
+  std::size_t new_block_size = std::max(block_size_, size);
+  blocks_.push_back({new char[new_block_size], new_block_size});
+  new_block_count_++;
+
+  current_block_ = blocks_.size() - 1;
+  current_offset_ = size;
+  return blocks_.back().memory;
+
+}
+
+}
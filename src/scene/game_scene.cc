@@ -1,50 +1,107 @@
-#include <random>
+#include <chrono>
+#include <algorithm>
 #include "scene/game_scene.h"
 #include "word_loader/string_word_loader.h"
 #include "word_loader/file_word_loader.h"
 #include "button/rectangular_button.h"
 #include "button/labeled_button.h"
 #include "boost/format.hpp"
+#include "storage/persistent_storage.h"
 
 namespace cross_language_match {
 
 GameScene::GameScene(SDL_Renderer *renderer,
                      SDL_Window *window,
                      bool &global_quit,
-                     int screen_height,
-                     int screen_width,
-                     std::map<std::string, std::string> word_pairs)
-    : Scene(renderer, window, global_quit),
-      screen_height_(screen_height),
-      screen_width_(screen_width) {
-
-  if (TTF_Init() == -1) {
-    throw std::runtime_error(
-        boost::str(boost::format("SDL_ttf could not be initialized, error: %1%\n") % TTF_GetError())
-    );
-  }
+                     FontCache *font_cache,
+                     Deck *deck)
+    : Scene(renderer, window, global_quit, font_cache),
+      deck_(deck),
+      session_snapshot_(kPersistentStorageDirectory) {
 
-  font_ = TTF_OpenFont("assets/fonts/OpenSans-Regular.ttf", font_size_);
+  font_ = font_cache_->GetFont(font_size_);
+  word_font_chain_ = font_cache_->GetWordFontChain(font_size_);
 
-  if (font_ == NULL) {
-    throw std::runtime_error(boost::str(boost::format("Failed to load font, error: %1%\n") % TTF_GetError()));
-  }
+  scheduler_ = new LeitnerScheduler(deck_);
 
-  remaining_word_pairs_ = new std::map<std::string, std::string>(word_pairs);
+  attempt_log_ = new AttemptLog(kPersistentStorageDirectory);
+  LoadAttemptHistory();
 
 }
 
 GameScene::~GameScene() {
 
-  TTF_CloseFont(font_);
-  font_ = nullptr;
-  TTF_Quit();
-
-  delete remaining_word_pairs_;
-
+  // Words and buffered attempts are cleaned up first, while the attempt log still exists
   RunPostLoop();
   CleanCurrentWords();
 
+  delete scheduler_;
+  scheduler_ = nullptr;
+
+  delete similarity_index_;
+  similarity_index_ = nullptr;
+
+  delete attempt_log_;
+  attempt_log_ = nullptr;
+
+  delete deck_watcher_;
+  deck_watcher_ = nullptr;
+
+  delete deck_;
+  deck_ = nullptr;
+
+}
+
+void GameScene::StartNewSession() {
+  new_session_is_pending_ = true;
+}
+
+bool GameScene::RestoreSession() {
+
+  if (!session_snapshot_.ReadState(deck_, scheduler_)
+      || !session_snapshot_.ReadRound(deck_->GetContentHash(), &restored_round_)
+      || !IsRestoredRoundValid()) {
+    printf("Saved session could not be restored\n");
+    return false;
+  }
+
+  // A round longer than fits on screen was one of a game of long rounds, which carries on as it was
+  if ((int) restored_round_.pair_indices.size() > words_to_present_per_round_) {
+    long_rounds_ = true;
+  }
+
+  has_restored_round_ = true;
+  session_is_active_ = true;
+  printf("Restored session at round %d\n", scheduler_->GetCurrentRound());
+  return true;
+
+}
+
+bool GameScene::WatchDeckFile(const std::string &file_path) {
+
+  if (deck_->IsPaged() || FileWordLoader(file_path).DetectCompression() != FileWordLoader::UNCOMPRESSED) {
+    printf("Edits to %s are only followed for fully loaded decks from plain word files\n", file_path.c_str());
+    return false;
+  }
+
+  delete deck_watcher_;
+  deck_watcher_ = new DeckWatcher(file_path, deck_);
+  return true;
+
+}
+
+void GameScene::SetSimilarityIndex(SimilarityIndex *similarity_index) {
+  delete similarity_index_;
+  similarity_index_ = similarity_index;
+  scheduler_->SetSimilarityIndex(similarity_index_);
+}
+
+void GameScene::UseLongRounds() {
+  long_rounds_ = true;
+}
+
+const char *GameScene::GetSceneName() {
+  return "GameScene";
 }
 
 void GameScene::RunPreLoop() {
@@ -52,7 +109,18 @@ void GameScene::RunPreLoop() {
   SDL_SetRenderDrawColor(renderer_, background_color_.r, background_color_.g, background_color_.b, background_color_.a);
   SDL_RenderClear(renderer_);
 
-  PrepareCurrentWords();
+  if (has_restored_round_) {
+    current_pair_indices_ = restored_round_.pair_indices;
+    right_order_ = restored_round_.right_order;
+    round_error_counts_ = restored_round_.error_counts;
+    round_results_recorded_ = restored_round_.results_recorded;
+    current_round_is_complete_ = restored_round_.round_complete;
+    BuildCurrentWords();
+    RestoreCurrentLinks();
+    has_restored_round_ = false;
+  } else {
+    PrepareCurrentWords();
+  }
 
   incorrect_text_ = new Text(renderer_, font_, plain_text_color_, "Incorrect; please try again.");
   correct_text_ = new Text(renderer_, font_, plain_text_color_, "Correct - well done!");
@@ -70,6 +138,10 @@ void GameScene::RunPreLoop() {
   next_round_button_event_ = NONE;
   return_button_event_ = NONE;
 
+}
+
+void GameScene::RunLayout() {
+
   // Submit button is in the bottom right
   submit_button_->SetTopLeftPosition(screen_width_ - 10 - submit_button_->GetWidth(),
                                      screen_height_ - submit_button_->GetHeight() - 10);
@@ -87,16 +159,40 @@ void GameScene::RunPreLoop() {
                                     screen_height_ - correct_text_->GetHeight() - 10);
   incorrect_text_->SetTopLeftPosition(screen_width_ / 2 - incorrect_text_->GetWidth() / 2,
                                       screen_height_ - incorrect_text_->GetHeight() - 10);
+
+  if (progress_text_ != nullptr) {
+    PositionProgressText();
+  }
+  PositionCurrentWords();
+  static_layer_is_current_ = false;
+
 }
 
 void GameScene::RunPostLoop() {
 
+  if (max_session_round_write_ms_ > 0) {
+    printf("Slowest session round snapshot took %.3f ms\n", max_session_round_write_ms_);
+  }
+  font_cache_->GetShapedTextCache()->PrintStats();
+
+  // Leaving the scene is the one moment where folding a long log into the snapshot cannot delay a frame
+  if (attempt_log_ != nullptr) {
+    attempt_log_->Flush();
+    attempt_log_->CompactIfNeeded();
+    SyncPersistentStorage();
+  }
+
   delete incorrect_text_;
   incorrect_text_ = nullptr;
 
   delete correct_text_;
   correct_text_ = nullptr;
 
+  delete progress_text_;
+  progress_text_ = nullptr;
+  progress_text_correct_count_ = -1;
+  progress_text_pair_count_ = -1;
+
   delete submit_text_;
   submit_text_ = nullptr;
 
@@ -115,6 +211,10 @@ void GameScene::RunPostLoop() {
   delete return_button_;
   return_button_ = nullptr;
 
+  EndDrag();
+  SDL_DestroyTexture(static_layer_);
+  static_layer_ = nullptr;
+
   submit_button_event_ = NONE;
   next_round_button_event_ = NONE;
   return_button_event_ = NONE;
@@ -127,18 +227,51 @@ void GameScene::RunSingleIterationEventHandler(SDL_Event &event) {
     QuitGlobal();
   }
 
-  for (auto &word : *left_and_right_words_) {
-    word->HandleEvent(&event, *left_and_right_words_);
+  if (!scrolling_columns_) {
+    for (auto &word : left_and_right_words_) {
+      word->HandleEvent(&event, left_and_right_words_);
+    }
+  } else if (IsMouseInColumnViewport()) {
+    // Only rows in view are hit-tested; those scrolled out of it may lie under the buttons
+    for (InteractiveTextGroup column : {LEFT, RIGHT}) {
+      std::vector<InteractiveText *> &words = GetColumnWords(column);
+      for (int row = first_bound_rows_[column]; row < bound_row_ends_[column]; row++) {
+        words[row]->HandleEvent(&event, left_and_right_words_);
+      }
+    }
+  }
+
+  HandleDragEvent(event);
+
+  // Each column scrolls on its own, so that a word can be matched with one far down the other column
+  if (scrolling_columns_ && event.type == SDL_MOUSEWHEEL) {
+    int mouse_x;
+    SDL_GetMouseState(&mouse_x, nullptr);
+    ScrollColumn(mouse_x < screen_width_ / 2 ? LEFT : RIGHT, -event.wheel.y * rows_per_wheel_step_ * row_pitch_);
+  }
+
+  if (event.type == SDL_MOUSEBUTTONDOWN || event.type == SDL_MOUSEBUTTONUP) {
+    session_round_dirty_ = true;
+  }
+
+  if (board_.GetLinkedPairCount() != observed_linked_pair_count_) {
+    UpdateLinkTimes();
   }
 
   submit_button_event_ = submit_button_->HandleEvent(&event);
 
   if (submit_button_event_ == PRESSED) {
-    if (AreAllWordsLinkedAndCorrect(left_and_right_words_, current_word_pairs_)) {
+    AppendSubmittedAttempts();
+    if (AreAllWordsLinkedAndCorrect()) {
       printf("Correct! Preparing next set of words!\n");
       last_submission_was_incorrect_ = false;
       current_round_is_complete_ = true;
+      RecordRoundResults();
+      if (session_is_active_) {
+        SaveSessionState();
+      }
     } else {
+      CountRoundErrors();
       last_submission_was_incorrect_ = true;
       // In case the submit button is pressed *after* the set has been matched correctly, the user has undid the
       // completion
@@ -147,13 +280,18 @@ void GameScene::RunSingleIterationEventHandler(SDL_Event &event) {
     }
   }
 
-  if (current_round_is_complete_ && remaining_word_pairs_->empty()) {
+  if (!all_rounds_complete_ && current_round_is_complete_ && scheduler_->IsComplete()) {
     printf("Correct! Game is over! All words done!\n");
     all_rounds_complete_ = true;
+    // Nothing is left to resume
+    session_snapshot_.Clear();
+    session_round_dirty_ = false;
   }
 
   next_round_button_event_ = next_round_button_->HandleEvent(&event);
-  if (next_round_button_event_ == PRESSED) {
+  // The button is only shown once the round is complete, and every pair of the round must have its result recorded
+  // with the scheduler before the next round is selected
+  if (next_round_button_event_ == PRESSED && current_round_is_complete_) {
     if (all_rounds_complete_) {
       QuitLocal();
     } else {
@@ -171,13 +309,48 @@ void GameScene::RunSingleIterationEventHandler(SDL_Event &event) {
 
 void GameScene::RunSingleIterationLoopBody() {
 
+  // Replacing the saved session waits for the first frame, which is then drawn from prepared words alone
+  if (new_session_is_pending_ && first_frame_presented_) {
+    WriteNewSession();
+  }
+
+  // Edits are applied before the round is saved, so that the saved round matches the edited deck
+  if (deck_watcher_ != nullptr && !all_rounds_complete_ && deck_watcher_->Poll(SDL_GetTicks(), &deck_edit_)) {
+    ApplyDeckEdit();
+  }
+
+  // Written here rather than per event so that a burst of clicks costs a single write
+  if (session_round_dirty_ && session_is_active_ && !all_rounds_complete_) {
+    SaveSessionRound();
+  }
+
+  if (drag_source_slot_ != MatchBoard::kNoSlot) {
+    RenderDragFrame();
+    return;
+  }
+
+  RenderScene();
+  SDL_RenderPresent(renderer_);
+  first_frame_presented_ = true;
+
+}
+
+void GameScene::RenderScene() {
+
   SDL_SetRenderDrawColor(renderer_, background_color_.r, background_color_.g, background_color_.b, background_color_.a);
   SDL_RenderClear(renderer_);
 
-  for (auto &word: *left_and_right_words_) {
-    word->Render();
+  if (scrolling_columns_) {
+    RenderScrollingColumns();
+  } else {
+    for (auto &word: left_and_right_words_) {
+      word->Render();
+    }
   }
 
+  UpdateProgressText();
+  progress_text_->Render();
+
   // We hide the submit button after the last round is completed; this signifies to the user that there are no
   // remaining actions
   if (!all_rounds_complete_) {
@@ -199,151 +372,765 @@ void GameScene::RunSingleIterationLoopBody() {
     incorrect_text_->Render();
   }
 
+}
+
+void GameScene::RenderDragFrame() {
+
+  auto start_time = std::chrono::steady_clock::now();
+  if (!static_layer_is_current_) {
+    UpdateStaticLayer();
+  }
+
+  // Without a static layer the scene is drawn in full, as at rest
+  if (static_layer_ != nullptr) {
+    SDL_RenderCopy(renderer_, static_layer_, nullptr, nullptr);
+  } else {
+    RenderScene();
+  }
+
+  int mouse_x;
+  int mouse_y;
+  SDL_GetMouseState(&mouse_x, &mouse_y);
+  left_and_right_words_[drag_source_slot_]->RenderDragLine(mouse_x, mouse_y);
   SDL_RenderPresent(renderer_);
 
+  double frame_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+  drag_frame_count_++;
+  total_drag_frame_ms_ += frame_ms;
+  max_drag_frame_ms_ = std::max(max_drag_frame_ms_, frame_ms);
+
+}
+
+void GameScene::UpdateStaticLayer() {
+
+  static_layer_is_current_ = true;
+  static_layer_update_count_++;
+
+  // The layer has a texel for each pixel of the window, however the window is scaled
+  int output_width;
+  int output_height;
+  SDL_GetRendererOutputSize(renderer_, &output_width, &output_height);
+  if (static_layer_ == nullptr || output_width != static_layer_width_ || output_height != static_layer_height_) {
+    SDL_DestroyTexture(static_layer_);
+    static_layer_ =
+        SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, output_width, output_height);
+    if (static_layer_ == nullptr) {
+      printf("Warning: unable to create the static layer; drags redraw the whole scene, error: %s\n",
+             SDL_GetError());
+      return;
+    }
+    static_layer_width_ = output_width;
+    static_layer_height_ = output_height;
+  }
+
+  // A texture target is drawn to unscaled, so it is given the window's scale for the scene to be laid out the same
+  float pixel_scale;
+  SDL_RenderGetScale(renderer_, &pixel_scale, nullptr);
+  SDL_SetRenderTarget(renderer_, static_layer_);
+  SDL_RenderSetScale(renderer_, pixel_scale, pixel_scale);
+  RenderScene();
+  SDL_SetRenderTarget(renderer_, nullptr);
+
+}
+
+InteractiveText *GameScene::FindWordUnderMouse() {
+
+  if (!scrolling_columns_) {
+    for (auto &word : left_and_right_words_) {
+      if (word->IsMouseInside()) {
+        return word;
+      }
+    }
+    return nullptr;
+  }
+
+  if (!IsMouseInColumnViewport()) {
+    return nullptr;
+  }
+  for (InteractiveTextGroup column : {LEFT, RIGHT}) {
+    std::vector<InteractiveText *> &words = GetColumnWords(column);
+    for (int row = first_bound_rows_[column]; row < bound_row_ends_[column]; row++) {
+      if (words[row]->IsMouseInside()) {
+        return words[row];
+      }
+    }
+  }
+  return nullptr;
+
+}
+
+void GameScene::HandleDragEvent(SDL_Event &event) {
+
+  // Pressing a word has just highlighted it, so a link can be dragged out of it
+  if (event.type == SDL_MOUSEBUTTONDOWN && event.button.button == SDL_BUTTON_LEFT) {
+    InteractiveText *word = FindWordUnderMouse();
+    if (word != nullptr && !word->IsLinked() && board_.IsHighlighted(word->GetSlot())) {
+      drag_source_slot_ = word->GetSlot();
+      static_layer_is_current_ = false;
+      drag_frame_count_ = 0;
+      static_layer_update_count_ = 0;
+      total_drag_frame_ms_ = 0;
+      max_drag_frame_ms_ = 0;
+      drag_start_time_ = std::chrono::steady_clock::now();
+    }
+    return;
+  }
+
+  if (drag_source_slot_ == MatchBoard::kNoSlot) {
+    return;
+  }
+
+  // Only the line follows the cursor; anything else may have changed what is under it
+  if (event.type != SDL_MOUSEBUTTONUP || event.button.button != SDL_BUTTON_LEFT) {
+    if (event.type != SDL_MOUSEMOTION) {
+      static_layer_is_current_ = false;
+    }
+    return;
+  }
+
+  // Dropping the link on a free word of the other column makes it as clicking that word would; dropping it anywhere
+  // else leaves the word highlighted, so that a link can still be made by clicking
+  InteractiveText *source = left_and_right_words_[drag_source_slot_];
+  InteractiveText *target = FindWordUnderMouse();
+  if (target != nullptr && target->GetGroup() != source->GetGroup() && !target->IsLinked() && !source->IsLinked()
+      && board_.IsHighlighted(drag_source_slot_)) {
+    source->RemoveHighlight();
+    source->AddLink(target);
+  }
+  EndDrag();
+
+}
+
+void GameScene::EndDrag() {
+
+  if (drag_source_slot_ == MatchBoard::kNoSlot) {
+    return;
+  }
+  drag_source_slot_ = MatchBoard::kNoSlot;
+
+  if (drag_frame_count_ > 0) {
+    double drag_ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - drag_start_time_).count();
+    printf("Drag of %d frames: %.3f ms mean and %.3f ms max to draw a frame, %.1f ms between frames, "
+           "%d static layer updates\n",
+           drag_frame_count_,
+           total_drag_frame_ms_ / drag_frame_count_,
+           max_drag_frame_ms_,
+           drag_ms / drag_frame_count_,
+           static_layer_update_count_);
+  }
+
+}
+
+bool GameScene::IsAnimating() {
+  return drag_source_slot_ != MatchBoard::kNoSlot;
 }
 
 void GameScene::PrepareCurrentWords() {
 
   CleanCurrentWords();
 
-  left_words_ = new std::vector<InteractiveText *>();
-  right_words_ = new std::vector<InteractiveText *>();
-  current_word_pairs_ = new std::map<std::string, std::string>();
+  int pair_count = long_rounds_ ? long_round_pair_count_ : words_to_present_per_round_;
+  auto start_time = std::chrono::steady_clock::now();
+  int selected_count = scheduler_->SelectRound(pair_count, &current_pair_indices_);
+  double select_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+  printf("Round %d: selected %d pairs (%d awaiting review, %d unseen) in %.3f ms\n",
+         scheduler_->GetCurrentRound(),
+         selected_count,
+         scheduler_->GetReviewCount(),
+         deck_->GetRemainingCount(),
+         select_ms);
 
-  // Move a subset of words from remaining_correct_word_pairs to current_correct_word_pairs
-  int remaining_count = words_to_present_per_round_;
-  for (auto &word_pair : *remaining_word_pairs_) {
-    if (remaining_count == 0) {
-      break;
-    }
-    current_word_pairs_->insert(word_pair);
-    remaining_count--;
+  round_error_counts_.assign(current_pair_indices_.size(), 0);
+  round_results_recorded_ = false;
+
+  // Shuffle so the left words and right words do not match up in the GUI
+  for (int i = 0; i < (int) current_pair_indices_.size(); i++) {
+    right_order_.push_back(i);
   }
-  for (auto &word_pair : *current_word_pairs_) {
-    remaining_word_pairs_->erase(word_pair.first);
+  deck_->Shuffle(&right_order_);
+
+  // The selection has moved the deck and scheduler on, so the saved state is stale from here
+  if (session_is_active_) {
+    SaveSessionState();
   }
+  session_round_dirty_ = true;
+
+  BuildCurrentWords();
+
+}
 
-  // Allocate new InteractiveText objects for current word pairs and add them to the vectors
-  for (auto &word_pair : *current_word_pairs_) {
-    left_words_->push_back(
-        new InteractiveText(renderer_, new Text(renderer_, font_, interactive_text_color_, word_pair.first), LEFT)
+void GameScene::BuildCurrentWords() {
+
+  round_link_times_ms_.assign(current_pair_indices_.size(), 0);
+  observed_linked_pair_count_ = 0;
+  round_start_ticks_ = SDL_GetTicks();
+
+  // Rows of scrolling columns are all as tall as the chain's first font, so that where each row lies is known before
+  // its word is rasterized
+  scrolling_columns_ = (int) current_pair_indices_.size() > words_to_present_per_round_;
+  int row_height = TTF_FontHeight(word_font_chain_->GetPrimaryFont()) + InteractiveText::GetPaddingPerSide() * 2;
+  row_pitch_ = row_height + padding_individual_words_;
+
+  // Board slots are assigned in the same order as left_and_right_words_, so a slot index doubles as an index into it.
+  // Every widget of the round comes from the round arena and is released with it in CleanCurrentWords.
+  board_.Clear();
+  for (int pair_index : current_pair_indices_) {
+    int slot = board_.AddSlot(deck_->GetLeftWordId(pair_index), LEFT, deck_->GetRightWordId(pair_index));
+    if (scrolling_columns_) {
+      left_words_.push_back(round_arena_.Create<InteractiveText>(renderer_, row_height, &board_, slot));
+      continue;
+    }
+    left_words_.push_back(
+        round_arena_.Create<InteractiveText>(renderer_,
+                                             round_arena_.Create<Text>(renderer_,
+                                                                       word_font_chain_,
+                                                                       interactive_text_color_,
+                                                                       deck_->GetLeftWord(pair_index)),
+                                             &board_,
+                                             slot)
     );
-    right_words_->push_back(
-        new InteractiveText(renderer_, new Text(renderer_, font_, interactive_text_color_, word_pair.second), RIGHT)
+  }
+  for (int i : right_order_) {
+    int pair_index = current_pair_indices_[i];
+    int slot = board_.AddSlot(deck_->GetRightWordId(pair_index), RIGHT, deck_->GetLeftWordId(pair_index));
+    if (scrolling_columns_) {
+      right_words_.push_back(round_arena_.Create<InteractiveText>(renderer_, row_height, &board_, slot));
+      continue;
+    }
+    right_words_.push_back(
+        round_arena_.Create<InteractiveText>(renderer_,
+                                             round_arena_.Create<Text>(renderer_,
+                                                                       word_font_chain_,
+                                                                       interactive_text_color_,
+                                                                       deck_->GetRightWord(pair_index)),
+                                             &board_,
+                                             slot)
     );
   }
 
-  // Shuffle so the left words and right words do not match up in the GUI
-  Shuffle(right_words_);
+  left_and_right_words_.insert(left_and_right_words_.end(), left_words_.begin(), left_words_.end());
+  left_and_right_words_.insert(left_and_right_words_.end(), right_words_.begin(), right_words_.end());
+
+  PositionCurrentWords();
+
+}
 
-  left_and_right_words_ = GetUnifiedVector(left_words_, right_words_);
+void GameScene::PositionCurrentWords() {
 
-  // Set the position of the words in both columns
-  int y = padding_individual_words_;
-  for (auto &left_word: *left_words_) {
-    left_word->SetTopLeftPosition(padding_word_columns_, y);
-    y += left_word->GetHeight() + padding_individual_words_;
+  if (scrolling_columns_) {
+    PositionScrollingColumns();
+  } else {
+    // Set the position of the words in both columns
+    int y = padding_individual_words_;
+    for (auto &left_word: left_words_) {
+      left_word->SetTopLeftPosition(padding_word_columns_, y);
+      y += left_word->GetHeight() + padding_individual_words_;
+    }
+    y = padding_individual_words_;
+    for (auto &right_word: right_words_) {
+      right_word->SetTopLeftPosition(screen_width_ - padding_word_columns_ - right_word->GetWidth(), y);
+      y += right_word->GetHeight() + padding_individual_words_;
+    }
   }
-  y = padding_individual_words_;
-  for (auto &right_word: *right_words_) {
-    right_word->SetTopLeftPosition(screen_width_ - padding_word_columns_ - right_word->GetWidth(), y);
-    y += right_word->GetHeight() + padding_individual_words_;
+
+  // Links drawn between the old positions follow their words
+  for (auto &left_word: left_words_) {
+    left_word->RebuildLinkGeometry(left_and_right_words_);
   }
 
 }
 
-void GameScene::CleanCurrentWords() {
+void GameScene::PositionScrollingColumns() {
+
+  // The columns fill the space between the progress text and the buttons. The left column is aligned to the right and
+  // the right column to the left, so a link always runs between the same two edges, whether or not its words have
+  // been rasterized.
+  int viewport_y = padding_individual_words_ + row_pitch_;
+  column_viewport_ = {padding_word_columns_,
+                      viewport_y,
+                      std::max(0, screen_width_ - padding_word_columns_ * 2),
+                      std::max(0, screen_height_ - button_height_ - 20 - viewport_y)};
+  int left_column_edge = screen_width_ / 2 - scrolling_column_gap_ / 2;
+  int right_column_edge = screen_width_ / 2 + scrolling_column_gap_ / 2;
+
+  for (InteractiveTextGroup column : {LEFT, RIGHT}) {
+
+    std::vector<InteractiveText *> &words = GetColumnWords(column);
+    int content_height = (int) words.size() * row_pitch_ - padding_individual_words_;
+    int max_scroll_offset = std::max(0, content_height - column_viewport_.h);
+    scroll_offsets_[column] = std::max(0, std::min(scroll_offsets_[column], max_scroll_offset));
+    BindVisibleRows(column);
+
+    // Placing a row costs no more than a few assignments, so rows out of view are placed too, for their links
+    int y = column_viewport_.y - scroll_offsets_[column];
+    for (InteractiveText *word : words) {
+      word->SetTopLeftPosition(column == LEFT ? left_column_edge - word->GetWidth() : right_column_edge, y);
+      y += row_pitch_;
+    }
 
-  if (left_words_ != nullptr) {
-    for (auto &word : *left_words_) {
-      if (word != nullptr) {
-        delete word->GetText();
-      }
-      delete word;
+  }
+
+}
+
+void GameScene::ScrollColumn(InteractiveTextGroup column, int delta) {
+  scroll_offsets_[column] += delta;
+  PositionCurrentWords();
+}
+
+void GameScene::BindVisibleRows(InteractiveTextGroup column) {
+
+  int row_count = (int) GetColumnWords(column).size();
+  int first = std::min(scroll_offsets_[column] / row_pitch_, row_count);
+  int end = std::min((scroll_offsets_[column] + column_viewport_.h + row_pitch_ - 1) / row_pitch_, row_count);
+
+  // Rows leaving the view go first, so that the rows coming into it can take their texts
+  for (int row = first_bound_rows_[column]; row < bound_row_ends_[column]; row++) {
+    if (row < first || row >= end) {
+      UnbindRow(column, row);
+    }
+  }
+  for (int row = first; row < end; row++) {
+    if (row < first_bound_rows_[column] || row >= bound_row_ends_[column]) {
+      BindRow(column, row);
     }
-    delete left_words_;
-    left_words_ = nullptr;
   }
 
-  if (right_words_ != nullptr) {
-    for (auto &word : *right_words_) {
-      if (word != nullptr) {
-        delete word->GetText();
-      }
-      delete word;
+  first_bound_rows_[column] = first;
+  bound_row_ends_[column] = std::max(first, end);
+
+}
+
+void GameScene::BindRow(InteractiveTextGroup column, int row) {
+
+  // Words scrolled back into view are usually still in the shaped text cache, so only the texture is made again
+  const char *word = GetRowWord(column, row);
+  Text *text;
+  if (free_texts_.empty()) {
+    text = round_arena_.Create<Text>(renderer_, word_font_chain_, interactive_text_color_, word);
+    created_text_count_++;
+  } else {
+    text = free_texts_.back();
+    free_texts_.pop_back();
+    text->SetString(word);
+  }
+
+  GetColumnWords(column)[row]->SetText(text);
+  bound_row_count_++;
+
+}
+
+void GameScene::UnbindRow(InteractiveTextGroup column, int row) {
+  free_texts_.push_back(GetColumnWords(column)[row]->ReleaseText());
+}
+
+const char *GameScene::GetRowWord(InteractiveTextGroup column, int row) {
+  if (column == LEFT) {
+    return deck_->GetLeftWord(current_pair_indices_[row]);
+  }
+  return deck_->GetRightWord(current_pair_indices_[right_order_[row]]);
+}
+
+std::vector<InteractiveText *> &GameScene::GetColumnWords(InteractiveTextGroup column) {
+  return column == LEFT ? left_words_ : right_words_;
+}
+
+bool GameScene::IsMouseInColumnViewport() {
+
+  int mouse_x;
+  int mouse_y;
+  SDL_GetMouseState(&mouse_x, &mouse_y);
+  return mouse_x >= column_viewport_.x && mouse_x < column_viewport_.x + column_viewport_.w
+      && mouse_y >= column_viewport_.y && mouse_y < column_viewport_.y + column_viewport_.h;
+
+}
+
+void GameScene::RenderScrollingColumns() {
+
+  // Words and links are cut off at the edges of the view
+  SDL_RenderSetClipRect(renderer_, &column_viewport_);
+
+  // A link whose left word is out of view is still drawn if it crosses the view; its right word may be out of view too
+  for (InteractiveText *left_word : left_words_) {
+    if (left_word->HasText() || !left_word->IsLinked()) {
+      continue;
+    }
+    InteractiveText *right_word = left_and_right_words_[board_.GetLink(left_word->GetSlot())];
+    int top_y = std::min(left_word->GetTopLeftY(), right_word->GetTopLeftY());
+    int bottom_y = std::max(left_word->GetTopLeftY(), right_word->GetTopLeftY()) + row_pitch_;
+    if (bottom_y > column_viewport_.y && top_y < column_viewport_.y + column_viewport_.h) {
+      left_word->RenderLink();
+    }
+  }
+
+  for (InteractiveTextGroup column : {LEFT, RIGHT}) {
+    std::vector<InteractiveText *> &words = GetColumnWords(column);
+    for (int row = first_bound_rows_[column]; row < bound_row_ends_[column]; row++) {
+      words[row]->Render();
+    }
+  }
+
+  SDL_RenderSetClipRect(renderer_, nullptr);
+
+  // A bar beside each column shows how much of it is in view, and where
+  SDL_SetRenderDrawColor(renderer_, plain_text_color_.r, plain_text_color_.g, plain_text_color_.b, 0xFF);
+  for (InteractiveTextGroup column : {LEFT, RIGHT}) {
+    int content_height = (int) GetColumnWords(column).size() * row_pitch_;
+    if (content_height <= column_viewport_.h) {
+      continue;
     }
-    delete right_words_;
-    right_words_ = nullptr;
+    SDL_Rect bar = {column == LEFT ? column_viewport_.x - 12 : column_viewport_.x + column_viewport_.w + 8,
+                    column_viewport_.y + scroll_offsets_[column] * column_viewport_.h / content_height,
+                    4,
+                    column_viewport_.h * column_viewport_.h / content_height};
+    SDL_RenderFillRect(renderer_, &bar);
   }
 
-  // left_and_right_words_ is either:
-  //   nullptr already
-  //   OR it holds all of the pointers already contained in left_words_ and right_words_ (if LoadWordsViaFile was invoked)
-  // In neither case do we want to invoke delete on the contents of it; hence, we just delete the container
-  delete left_and_right_words_;
-  left_and_right_words_ = nullptr;
+}
 
-  delete current_word_pairs_;
-  current_word_pairs_ = nullptr;
+void GameScene::RestoreCurrentLinks() {
+
+  // Links are saved per left slot; left slots come first, so the left slot of the i-th pair is slot i
+  for (int i = 0; i < (int) restored_round_.links.size(); i++) {
+    if (restored_round_.links[i] != MatchBoard::kNoSlot) {
+      left_and_right_words_[i]->AddLink(left_and_right_words_[restored_round_.links[i]]);
+    }
+  }
+  UpdateLinkTimes();
 
 }
 
-void GameScene::Shuffle(std::vector<InteractiveText *> *vector) {
+void GameScene::CleanCurrentWords() {
+
+  // Round boundaries are already paying for rasterization, so this is where buffered attempts are written out
+  if (attempt_log_ != nullptr) {
+    attempt_log_->Flush();
+    SyncPersistentStorage();
+  }
 
-  std::shuffle(vector->begin(),
-               vector->end(),
-               std::default_random_engine(std::chrono::system_clock::now().time_since_epoch().count())
-  );
+  if (round_arena_.GetAllocationCount() > 0) {
+    printf("Round made %d arena allocations, which added %d new arena blocks\n",
+           round_arena_.GetAllocationCount(),
+           round_arena_.GetNewBlockCount());
+    printf("Deck memory: %d KB resident, %d KB peak, %d page loads\n",
+           (int) (deck_->GetResidentBytes() / 1024),
+           (int) (deck_->GetPeakResidentBytes() / 1024),
+           deck_->GetPageLoadCount());
+  }
+  if (scrolling_columns_) {
+    printf("Scrolling round of %d pairs drew %d rows into view with %d texts\n",
+           (int) current_pair_indices_.size(),
+           bound_row_count_,
+           created_text_count_);
+  }
+
+  // The containers only hold pointers into the arena; clearing them keeps their capacity for the next round, and the
+  // arena destroys every widget of the round in one pass
+  left_words_.clear();
+  right_words_.clear();
+  left_and_right_words_.clear();
+  free_texts_.clear();
+  round_arena_.Release();
+
+  scrolling_columns_ = false;
+  for (InteractiveTextGroup column : {LEFT, RIGHT}) {
+    scroll_offsets_[column] = 0;
+    first_bound_rows_[column] = 0;
+    bound_row_ends_[column] = 0;
+  }
+  bound_row_count_ = 0;
+  created_text_count_ = 0;
+
+  current_pair_indices_.clear();
+  right_order_.clear();
+
+  // The word a link was being dragged out of is gone with the round
+  EndDrag();
 
 }
 
-std::vector<InteractiveText *> *GameScene::GetUnifiedVector(std::vector<InteractiveText *> *a,
-                                                            std::vector<InteractiveText *> *b) {
+bool GameScene::AreAllWordsLinkedAndCorrect() {
+
+  if (!board_.AreAllPairsLinked()) {
+    printf("%d of %d pairs are linked; all words must be paired up for submission to occur.\n",
+           board_.GetLinkedPairCount(),
+           board_.GetPairCount());
+    return false;
+  }
 
-  std::vector<InteractiveText *> *all_words = new std::vector<InteractiveText *>();
-  all_words->insert(all_words->end(), a->begin(), a->end());
-  all_words->insert(all_words->end(), b->begin(), b->end());
-  return all_words;
+  if (!board_.AreAllPairsLinkedAndCorrect()) {
+    printf("%d of %d pairs are linked incorrectly\n",
+           board_.GetPairCount() - board_.GetCorrectPairCount(),
+           board_.GetPairCount());
+    return false;
+  }
+
+  return true;
 
 }
 
-bool GameScene::AreAllWordsLinkedAndCorrect(std::vector<InteractiveText *> *all_words,
-                                            std::map<std::string, std::string> *expected_word_pairs) {
+void GameScene::CountRoundErrors() {
 
-  // Ensure all words have been paired up
-  for (auto &word : *all_words) {
-    if (word->GetLink() == nullptr) {
-      printf("Word (%s) is not paired up; all words must be paired up for submission to occur.\n",
-             word->GetText()->GetString().c_str());
-      return false;
+  // Left slots were added in the order of current_pair_indices_, so slot i belongs to the i-th pair of the round
+  for (int i = 0; i < (int) current_pair_indices_.size(); i++) {
+    if (board_.IsLinked(i) && !board_.IsLinkCorrect(i)) {
+      round_error_counts_[i]++;
     }
   }
 
-  for (auto &word : *all_words) {
+}
+
+void GameScene::RecordRoundResults() {
+
+  // A completed round can be undone and submitted again; only its first completion counts
+  if (round_results_recorded_) {
+    return;
+  }
+
+  for (int i = 0; i < (int) current_pair_indices_.size(); i++) {
+    scheduler_->RecordResult(current_pair_indices_[i], round_error_counts_[i]);
+  }
+  round_results_recorded_ = true;
+
+}
+
+void GameScene::LoadAttemptHistory() {
 
-    // Only need to inspect left words since they've been shown to be paired to all right words already
-    if (word->GetGroup() != LEFT) {
+  Uint32 start_ticks = SDL_GetTicks();
+  attempt_history_ = attempt_log_->LoadStats();
+
+  // Matching the history against pairs as they are drawn keeps the start of the game from touching every pair, which
+  // for a paged deck would mean reading the whole deck
+  scheduler_->SetHistoricalErrorSource([this](int pair_index) {
+    const PairStats *pair_stats =
+        AttemptLog::FindStats(attempt_history_, AttemptLog::GetPairKey(deck_->GetLeftWord(pair_index),
+                                                                       deck_->GetRightWord(pair_index)));
+    return pair_stats == nullptr ? 0 : (int) (pair_stats->attempt_count - pair_stats->correct_count);
+  });
+
+  printf("Loaded attempt history (%d pairs on record) in %d ms\n",
+         (int) attempt_history_.size(),
+         (int) (SDL_GetTicks() - start_ticks));
+
+}
+
+void GameScene::UpdateLinkTimes() {
+
+  Uint32 elapsed_ms = SDL_GetTicks() - round_start_ticks_;
+  for (int i = 0; i < (int) current_pair_indices_.size(); i++) {
+    if (!board_.IsLinked(i)) {
+      round_link_times_ms_[i] = 0;
+    } else if (round_link_times_ms_[i] == 0) {
+      round_link_times_ms_[i] = std::max<Uint32>(elapsed_ms, 1);
+    }
+  }
+  observed_linked_pair_count_ = board_.GetLinkedPairCount();
+
+}
+
+void GameScene::AppendSubmittedAttempts() {
+
+  // Records are only buffered here; they reach the file system at the next round boundary
+  for (int i = 0; i < (int) current_pair_indices_.size(); i++) {
+    if (!board_.IsLinked(i)) {
       continue;
     }
+    int pair_index = current_pair_indices_[i];
+    attempt_log_->Append(AttemptLog::GetPairKey(deck_->GetLeftWord(pair_index), deck_->GetRightWord(pair_index)),
+                         board_.IsLinkCorrect(i),
+                         round_link_times_ms_[i]);
+  }
+
+}
+
+void GameScene::UpdateProgressText() {
+
+  if (progress_text_ != nullptr
+      && progress_text_correct_count_ == board_.GetCorrectPairCount()
+      && progress_text_pair_count_ == board_.GetPairCount()) {
+    return;
+  }
+
+  progress_text_correct_count_ = board_.GetCorrectPairCount();
+  progress_text_pair_count_ = board_.GetPairCount();
+
+  delete progress_text_;
+  progress_text_ = new Text(renderer_,
+                            font_,
+                            plain_text_color_,
+                            boost::str(boost::format("%1%/%2% correct")
+                                           % progress_text_correct_count_
+                                           % progress_text_pair_count_));
+  PositionProgressText();
+
+}
 
-    std::string left_word_str = word->GetText()->GetString();
-    std::string actual_linked_right_word = word->GetLink()->GetText()->GetString();
-    std::string expected_linked_right_word = (*expected_word_pairs)[left_word_str];
+void GameScene::PositionProgressText() {
 
-    if (actual_linked_right_word != expected_linked_right_word) {
-      printf(
-          "Left word (%s) is linked to right word (%s) but this is incorrect; expected it to be linked to (%s)\n",
-          left_word_str.c_str(),
-          actual_linked_right_word.c_str(),
-          expected_linked_right_word.c_str());
+  // Progress is shown in the top middle, between the two word columns
+  progress_text_->SetTopLeftPosition(screen_width_ / 2 - progress_text_->GetWidth() / 2, padding_individual_words_);
+
+}
+
+bool GameScene::IsRestoredRoundValid() {
+
+  const RoundSnapshot &round = restored_round_;
+  int pair_count = (int) round.pair_indices.size();
+  if (round.scheduler_round != scheduler_->GetCurrentRound()
+      || pair_count == 0
+      || (int) round.right_order.size() != pair_count
+      || (int) round.links.size() != pair_count
+      || (int) round.error_counts.size() != pair_count) {
+    return false;
+  }
+
+  std::vector<bool> seen(pair_count, false);
+  for (int i = 0; i < pair_count; i++) {
+    int order = round.right_order[i];
+    if (round.pair_indices[i] < 0 || round.pair_indices[i] >= deck_->GetPairCount()
+        || order < 0 || order >= pair_count || seen[order]) {
+      return false;
+    }
+    seen[order] = true;
+    // Right slots follow the left slots
+    int link = round.links[i];
+    if (link != MatchBoard::kNoSlot && (link < pair_count || link >= 2 * pair_count)) {
       return false;
     }
-
   }
 
   return true;
 
 }
 
+void GameScene::WriteNewSession() {
+
+  new_session_is_pending_ = false;
+  session_snapshot_.Clear();
+  // Decks read line by line from the word file cannot be compiled, and per-pair state without its deck could never
+  // be resumed, so such games go unsaved
+  if (!session_snapshot_.WriteDeck(deck_)) {
+    printf("Deck could not be saved; this game will not be resumable\n");
+    session_snapshot_.Clear();
+    return;
+  }
+  session_is_active_ = true;
+
+  // The round on screen was selected before the session existed
+  SaveSessionState();
+  session_round_dirty_ = true;
+
+}
+
+void GameScene::SaveSessionState() {
+  if (session_snapshot_.WriteState(deck_, scheduler_)) {
+    SyncPersistentStorage();
+  }
+}
+
+void GameScene::SaveSessionRound() {
+
+  auto start_time = std::chrono::steady_clock::now();
+
+  RoundSnapshot round;
+  round.scheduler_round = scheduler_->GetCurrentRound();
+  round.pair_indices = current_pair_indices_;
+  round.right_order = right_order_;
+  round.error_counts = round_error_counts_;
+  round.results_recorded = round_results_recorded_;
+  round.round_complete = current_round_is_complete_;
+  for (int i = 0; i < (int) current_pair_indices_.size(); i++) {
+    round.links.push_back(board_.GetLink(i));
+  }
+
+  bool written = session_snapshot_.WriteRound(deck_->GetContentHash(), round);
+  session_round_dirty_ = false;
+
+  double elapsed_ms =
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+  max_session_round_write_ms_ = std::max(max_session_round_write_ms_, elapsed_ms);
+
+  if (written) {
+    SyncPersistentStorage();
+  }
+
+}
+
+void GameScene::ApplyDeckEdit() {
+
+  for (std::size_t i = 0; i < deck_edit_.added_pairs.size(); i++) {
+    scheduler_->AddPair();
+  }
+  // A removed pair in the current round stays on screen until the round ends, but its result is no longer recorded
+  for (int pair_index : deck_edit_.removed_pairs) {
+    scheduler_->RemovePair(pair_index);
+  }
+
+  // Only the words that changed are rasterized again; the rest of the round is left as it is
+  for (int i = 0; i < (int) current_pair_indices_.size(); i++) {
+    if (std::find(deck_edit_.changed_pairs.begin(), deck_edit_.changed_pairs.end(), current_pair_indices_[i])
+        != deck_edit_.changed_pairs.end()) {
+      ReplaceRightWord(i);
+    }
+  }
+  static_layer_is_current_ = false;
+
+  // Saved pair indices refer to the edited deck, so the deck is saved again along with the state
+  if (session_is_active_) {
+    if (session_snapshot_.WriteDeck(deck_)) {
+      SaveSessionState();
+    } else {
+      printf("Edited deck could not be saved; this game will no longer be resumable\n");
+      session_snapshot_.Clear();
+      session_is_active_ = false;
+    }
+  }
+  session_round_dirty_ = true;
+
+}
+
+void GameScene::ReplaceRightWord(int round_pair) {
+
+  int pair_index = current_pair_indices_[round_pair];
+  int left_slot = round_pair;
+  int right_slot = (int) current_pair_indices_.size()
+      + (int) (std::find(right_order_.begin(), right_order_.end(), round_pair) - right_order_.begin());
+  InteractiveText *right_word = left_and_right_words_[right_slot];
+
+  // Links touching either slot are taken down while the word IDs change, so that the board's counts stay right, and
+  // put back afterwards with their geometry rebuilt for the resized word
+  int left_link = board_.GetLink(left_slot);
+  int right_link = board_.GetLink(right_slot);
+  if (left_link != MatchBoard::kNoSlot) {
+    left_and_right_words_[left_slot]->RemoveLink();
+  }
+  if (right_link != MatchBoard::kNoSlot && right_link != left_slot) {
+    left_and_right_words_[right_link]->RemoveLink();
+  }
+
+  board_.SetExpectedPartnerWordId(left_slot, deck_->GetRightWordId(pair_index));
+  board_.SetWordId(right_slot, deck_->GetRightWordId(pair_index));
+  if (!scrolling_columns_) {
+    right_word->SetText(round_arena_.Create<Text>(renderer_,
+                                                  word_font_chain_,
+                                                  interactive_text_color_,
+                                                  deck_->GetRightWord(pair_index)));
+    right_word->SetTopLeftPosition(screen_width_ - padding_word_columns_ - right_word->GetWidth(),
+                                   right_word->GetTopLeftY());
+  } else if (right_word->HasText()) {
+    // A row of a scrolling column keeps its left edge; one out of view picks up the edit when it comes into view
+    Text *text = right_word->ReleaseText();
+    text->SetString(deck_->GetRightWord(pair_index));
+    right_word->SetText(text);
+  }
+
+  if (left_link != MatchBoard::kNoSlot) {
+    left_and_right_words_[left_slot]->AddLink(left_and_right_words_[left_link]);
+  }
+  if (right_link != MatchBoard::kNoSlot && right_link != left_slot) {
+    left_and_right_words_[right_link]->AddLink(right_word);
+  }
+
+}
+
 }
@@ -7,40 +7,17 @@ namespace cross_language_match {
 HelpScene::HelpScene(SDL_Renderer *renderer,
                      SDL_Window *window,
                      bool &global_quit,
-                     int screen_height,
-                     int screen_width)
-    : Scene(renderer, window, global_quit),
-      screen_height_(screen_height),
-      screen_width_(screen_width) {
-
-  if (TTF_Init() == -1) {
-    throw std::runtime_error(
-        boost::str(boost::format("SDL_ttf could not be initialized, error: %1%\n") % TTF_GetError())
-    );
-  }
+                     FontCache *font_cache)
+    : Scene(renderer, window, global_quit, font_cache) {
 
-  return_button_font_ = TTF_OpenFont("assets/fonts/OpenSans-Regular.ttf", button_font_size_);
-  if (return_button_font_ == nullptr) {
-    throw std::runtime_error(boost::str(boost::format("Failed to load font, error: %1%\n") % TTF_GetError()));
-  }
+  return_button_font_ = font_cache_->GetFont(button_font_size_);
 
-  explanation_font_ = TTF_OpenFont("assets/fonts/OpenSans-Regular.ttf", explanation_font_size_);
-  if (explanation_font_ == nullptr) {
-    throw std::runtime_error(boost::str(boost::format("Failed to load font, error: %1%\n") % TTF_GetError()));
-  }
+  explanation_font_ = font_cache_->GetFont(explanation_font_size_);
 
 }
 
-HelpScene::~HelpScene() {
-
-  TTF_CloseFont(return_button_font_);
-  return_button_font_ = nullptr;
-
-  TTF_CloseFont(explanation_font_);
-  explanation_font_ = nullptr;
-
-  TTF_Quit();
-
+const char *HelpScene::GetSceneName() {
+  return "HelpScene";
 }
 
 void HelpScene::RunPreLoop() {
@@ -61,6 +38,10 @@ void HelpScene::RunPreLoop() {
                                "a word, and left click on the corresponding word from the other side to form a link. "
                                "Click the X on the link in order to delete the link.", 1100);
 
+}
+
+void HelpScene::RunLayout() {
+
   // Set submit button position to be in bottom middle
   return_button_->SetTopLeftPosition(screen_width_ / 2 - return_button_->GetWidth() / 2,
                                      screen_height_ - return_button_->GetHeight() - 100);
@@ -76,6 +57,8 @@ void HelpScene::RunPostLoop() {
   delete return_text_;
   return_text_ = nullptr;
 
+  delete return_button_;
+  return_button_ = nullptr;
   return_button_event_ = NONE;
 
   delete explanation_text_;
@@ -107,4 +90,12 @@ void HelpScene::RunSingleIterationLoopBody() {
 
 }
 
-}
\ No newline at end of file
+void HelpScene::RunOnEnter() {
+  return_button_event_ = NONE;
+}
+
+bool HelpScene::IsReusable() {
+  return true;
+}
+
+}
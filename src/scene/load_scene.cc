@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <chrono>
 #include <SDL2/SDL.h>
 #include <SDL_ttf.h>
 #include <boost/format.hpp>
@@ -6,32 +7,22 @@
 #include "button/labeled_button.h"
 #include "button/rectangular_button.h"
 #include "scene/game_scene.h"
+#include "scene/scene_manager.h"
+#include "scene/typed_game_scene.h"
+#include "storage/persistent_storage.h"
 #include "word_loader/file_word_loader.h"
 #include <emscripten.h>
 
 namespace cross_language_match {
 
-// Emscripten exporting only works for C functions
-// This function is intended to be exported with Emscripten so it can be invoked via Javascript to
-// persist a web-loaded file in the local virtual filesystem (so it can be accessed in the game).
-extern "C" {
-void persist_file(char *contents_to_persist) {
-  FILE *file = fopen(cross_language_match::kEmscriptenInputFilePath, "w+");
-  fprintf(file, "%s", contents_to_persist);
-  fclose(file);
-}
-}
-
 EM_JS(
     void,
     load_file,
-    (const char *loaded_file_name),
+    (const char *loaded_file_name, const char *file_path_ptr),
     {
-      var input = document.createElement('input');
-      input.type = 'file';
-      input.onchange = e => {
+      var file_path = UTF8ToString(file_path_ptr);
 
-        var file_blob = e.target.files[0];
+      var read_file = function(file_blob) {
 
         if (file_blob.length == 0) {
           return;
@@ -41,14 +32,32 @@ EM_JS(
 
         reader.onload = function()
         {
-          var data_str = reader.result;
-          Module.ccall('persist_file', null,["string"],[data_str]);
+          // The bytes are written as they are, so compressed files arrive intact and are only decompressed while
+          // being parsed
+          FS.writeFile(file_path, new Uint8Array(reader.result));
+          Module.deckFileLastModified = file_blob.lastModified;
           // Populate the passed in filename variable
           stringToUTF8(file_blob.name, loaded_file_name, lengthBytesUTF8(file_blob.name) + 1);
         };
 
-        reader.readAsText(file_blob);
+        reader.readAsArrayBuffer(file_blob);
+
+      };
+
+      // A file system handle can be read again after the file is edited, where a file from an input element cannot
+      Module.deckFileHandle = null;
+      if (window.showOpenFilePicker) {
+        window.showOpenFilePicker().then(handles => {
+          Module.deckFileHandle = handles[0];
+          return handles[0].getFile();
+        }).then(read_file).catch(error => console.log(error));
+        return;
+      }
 
+      var input = document.createElement('input');
+      input.type = 'file';
+      input.onchange = e => {
+        read_file(e.target.files[0]);
       };
 
       input.click();
@@ -56,43 +65,56 @@ EM_JS(
     }
 );
 
+// Copies the picked file into the file system again whenever it is saved, for the game to pick up the edit; browsers
+// without file system handles have nothing to poll
+EM_JS(
+    void,
+    follow_file_edits,
+    (const char *file_path_ptr, int poll_interval_ms),
+    {
+      var file_path = UTF8ToString(file_path_ptr);
+      var handle = Module.deckFileHandle;
+      clearInterval(Module.deckFileTimer);
+      if (!handle) {
+        return;
+      }
+
+      Module.deckFileTimer = setInterval(() => {
+        handle.getFile().then(file => {
+          if (file.lastModified == Module.deckFileLastModified) {
+            return;
+          }
+          Module.deckFileLastModified = file.lastModified;
+          return file.arrayBuffer().then(buffer => FS.writeFile(file_path, new Uint8Array(buffer)));
+        }).catch(error => console.log(error));
+      }, poll_interval_ms);
+    }
+);
+
+EM_JS(
+    void,
+    stop_following_file_edits,
+    (),
+    {
+      clearInterval(Module.deckFileTimer);
+    }
+);
+
 LoadScene::LoadScene(SDL_Renderer *renderer,
                      SDL_Window *window,
                      bool &global_quit,
-                     int screen_height,
-                     int screen_width)
-    : Scene(renderer, window, global_quit),
-      screen_height_(screen_height),
-      screen_width_(screen_width) {
+                     FontCache *font_cache)
+    : Scene(renderer, window, global_quit, font_cache),
+      deck_cache_(kDeckCacheDirectory) {
 
-  if (TTF_Init() == -1) {
-    throw std::runtime_error(
-        boost::str(boost::format("SDL_ttf could not be initialized, error: %1%\n") % TTF_GetError())
-    );
-  }
+  button_font_ = font_cache_->GetFont(wide_button_font_size_);
 
-  button_font_ = TTF_OpenFont("assets/fonts/OpenSans-Regular.ttf", wide_button_font_size_);
-  if (button_font_ == nullptr) {
-    throw std::runtime_error(boost::str(boost::format("Failed to load font, error: %1%\n") % TTF_GetError()));
-  }
-
-  small_font_ = TTF_OpenFont("assets/fonts/OpenSans-Regular.ttf", small_font_size_);
-  if (small_font_ == nullptr) {
-    throw std::runtime_error(boost::str(boost::format("Failed to load font, error: %1%\n") % TTF_GetError()));
-  }
+  small_font_ = font_cache_->GetFont(small_font_size_);
 
 }
 
-LoadScene::~LoadScene() {
-
-  TTF_CloseFont(button_font_);
-  button_font_ = nullptr;
-
-  TTF_CloseFont(small_font_);
-  small_font_ = nullptr;
-
-  TTF_Quit();
-
+const char *LoadScene::GetSceneName() {
+  return "LoadScene";
 }
 
 void LoadScene::RunPreLoop() {
@@ -112,6 +134,27 @@ void LoadScene::RunPreLoop() {
       new LabeledButton(RectangularButton(Rectangle(renderer_, wide_button_width_, wide_button_height_)), begin_text_);
   begin_button_event_ = NONE;
 
+  hard_rounds_off_text_ = new Text(renderer_, button_font_, button_text_color_, "Hard Rounds: Off");
+  hard_rounds_on_text_ = new Text(renderer_, button_font_, button_text_color_, "Hard Rounds: On");
+  hard_rounds_button_ =
+      new LabeledButton(RectangularButton(Rectangle(renderer_, wide_button_width_, wide_button_height_)),
+                        hard_rounds_ ? hard_rounds_on_text_ : hard_rounds_off_text_);
+  hard_rounds_button_event_ = NONE;
+
+  long_rounds_off_text_ = new Text(renderer_, button_font_, button_text_color_, "Long Rounds: Off");
+  long_rounds_on_text_ = new Text(renderer_, button_font_, button_text_color_, "Long Rounds: On");
+  long_rounds_button_ =
+      new LabeledButton(RectangularButton(Rectangle(renderer_, wide_button_width_, wide_button_height_)),
+                        long_rounds_ ? long_rounds_on_text_ : long_rounds_off_text_);
+  long_rounds_button_event_ = NONE;
+
+  typed_answers_off_text_ = new Text(renderer_, button_font_, button_text_color_, "Typed Answers: Off");
+  typed_answers_on_text_ = new Text(renderer_, button_font_, button_text_color_, "Typed Answers: On");
+  typed_answers_button_ =
+      new LabeledButton(RectangularButton(Rectangle(renderer_, wide_button_width_, wide_button_height_)),
+                        typed_answers_ ? typed_answers_on_text_ : typed_answers_off_text_);
+  typed_answers_button_event_ = NONE;
+
   return_button_text_ = new Text(renderer_, button_font_, button_text_color_, "Main Menu");
   return_button_ =
       new LabeledButton(RectangularButton(Rectangle(renderer_, return_button_width_, return_button_height_)),
@@ -128,6 +171,10 @@ void LoadScene::RunPreLoop() {
                                               % begin_button_text),
                                1100);
 
+}
+
+void LoadScene::RunLayout() {
+
   // Set the explanation to be in the top middle
   explanation_text_->SetTopLeftPosition(screen_width_ / 2 - explanation_text_->GetWidth() / 2,
                                         explanation_text_->GetHeight() + 100);
@@ -135,6 +182,14 @@ void LoadScene::RunPreLoop() {
   load_button_->SetTopLeftPosition(screen_width_ / 2 - load_button_->GetWidth() / 2,
                                    screen_height_ - load_button_->GetHeight() - 300);
 
+  // Set the mode buttons side by side just above the load button
+  long_rounds_button_->SetTopLeftPosition(screen_width_ / 2 - long_rounds_button_->GetWidth() / 2,
+                                          load_button_->GetTopLeftY() - long_rounds_button_->GetHeight() - 10);
+  hard_rounds_button_->SetTopLeftPosition(long_rounds_button_->GetTopLeftX() - hard_rounds_button_->GetWidth() - 10,
+                                          long_rounds_button_->GetTopLeftY());
+  typed_answers_button_->SetTopLeftPosition(long_rounds_button_->GetTopLeftX() + long_rounds_button_->GetWidth() + 10,
+                                            long_rounds_button_->GetTopLeftY());
+
   // Set begin button to be just below the load button
   begin_button_->SetTopLeftPosition(screen_width_ / 2 - begin_button_->GetWidth() / 2,
                                     load_button_->GetTopLeftY() + load_button_->GetHeight() + 10);
@@ -143,6 +198,8 @@ void LoadScene::RunPreLoop() {
   return_button_->SetTopLeftPosition(screen_width_ - 10 - return_button_->GetWidth(),
                                      screen_height_ - return_button_->GetHeight() - 10);
 
+  PositionMessage();
+
 }
 
 void LoadScene::RunPostLoop() {
@@ -159,52 +216,200 @@ void LoadScene::RunPostLoop() {
   begin_button_ = nullptr;
   begin_button_event_ = NONE;
 
+  delete hard_rounds_button_;
+  hard_rounds_button_ = nullptr;
+  delete hard_rounds_off_text_;
+  hard_rounds_off_text_ = nullptr;
+  delete hard_rounds_on_text_;
+  hard_rounds_on_text_ = nullptr;
+  hard_rounds_button_event_ = NONE;
+
+  delete long_rounds_button_;
+  long_rounds_button_ = nullptr;
+  delete long_rounds_off_text_;
+  long_rounds_off_text_ = nullptr;
+  delete long_rounds_on_text_;
+  long_rounds_on_text_ = nullptr;
+  long_rounds_button_event_ = NONE;
+
+  delete typed_answers_button_;
+  typed_answers_button_ = nullptr;
+  delete typed_answers_off_text_;
+  typed_answers_off_text_ = nullptr;
+  delete typed_answers_on_text_;
+  typed_answers_on_text_ = nullptr;
+  typed_answers_button_event_ = NONE;
+
   delete explanation_text_;
   explanation_text_ = nullptr;
 
   delete error_text_;
   error_text_ = nullptr;
 
+  delete warning_text_;
+  warning_text_ = nullptr;
+
   delete return_button_text_;
   return_button_text_ = nullptr;
   delete return_button_;
   return_button_ = nullptr;
   return_button_event_ = NONE;
 
+  ClearLoadedFile();
+
+}
+
+void LoadScene::ClearLoadedFile() {
+
+  DiscardPrewarmedGame();
+
   if (loaded_file_name_ != nullptr) {
     free(loaded_file_name_);
     loaded_file_name_ = nullptr;
   }
+  loaded_file_has_been_processed_ = false;
+  begin_button_presented_ = false;
 
   delete word_loader_;
   word_loader_ = nullptr;
 
+  delete similarity_index_;
+  similarity_index_ = nullptr;
+
+  delete word_trie_;
+  word_trie_ = nullptr;
+
+  delete deck_;
+  deck_ = nullptr;
+
 }
 
 void LoadScene::ClearErrorMessage() {
   delete error_text_;
   error_text_ = nullptr;
+  delete warning_text_;
+  warning_text_ = nullptr;
 }
 
 void LoadScene::SetErrorMessage(std::string error_message) {
   ClearErrorMessage();
   error_text_ = new Text(renderer_, small_font_, small_font_color_, error_message, 1000);
-  error_text_->SetTopLeftPosition(screen_width_ / 2 - error_text_->GetWidth() / 2,
-                                  screen_height_ - wide_button_height_ - 100);
+  PositionMessage();
+}
+
+void LoadScene::SetWarningMessage(std::string warning_message) {
+  ClearErrorMessage();
+  warning_text_ = new Text(renderer_, small_font_, small_font_color_, warning_message, 1000);
+  PositionMessage();
+}
+
+void LoadScene::PositionMessage() {
+
+  // At most one message is shown at a time
+  Text *message_text = error_text_ != nullptr ? error_text_ : warning_text_;
+  if (message_text == nullptr) {
+    return;
+  }
+  message_text->SetTopLeftPosition(screen_width_ / 2 - message_text->GetWidth() / 2,
+                                   screen_height_ - wide_button_height_ - 100);
+
 }
 
 void LoadScene::HandleBeginEvent(SDL_Event &event) {
 
-  GameScene game_scene = GameScene(renderer_, window_, global_quit_, screen_height_, screen_width_,
-                                   word_loader_->GetWordPairMap());
-  game_scene.Run();
+  if (typed_answers_) {
+    BuildWordTrie();
+    TypedGameScene *typed_game_scene = new TypedGameScene(
+        renderer_, window_, global_quit_, font_cache_, deck_, word_trie_);
+    deck_ = nullptr;
+    word_trie_ = nullptr;
+    if (similarity_index_ != nullptr) {
+      typed_game_scene->SetSimilarityIndex(similarity_index_);
+      similarity_index_ = nullptr;
+    }
+    scene_manager_->Push(typed_game_scene);
+    game_has_started_ = true;
+    return;
+  }
+
+  // The game is usually prepared while Begin waits to be clicked, so its first frame needs no work at all
+  GameScene *game_scene = game_is_prewarmed_ ? scene_manager_->TakeHeldScene<GameScene>() : CreateGameScene();
+  game_is_prewarmed_ = false;
+  scene_manager_->Push(game_scene);
+  game_scene->StartNewSession();
+  // Paged decks read their lines from the file during the game, so it is only rewritten for a game watching it
+  if (deck_file_is_watched_) {
+    follow_file_edits(kEmscriptenInputFilePath, DeckWatcher::kDefaultPollIntervalMs);
+  } else {
+    stop_following_file_edits();
+  }
+  game_has_started_ = true;
+
+}
 
-  // The loading scene should only be entered from the front; after the game scene runs, we actually want to exit
-  // out of the load scene as well
-  QuitLocal();
+GameScene *LoadScene::CreateGameScene() {
+
+  GameScene *game_scene =
+      new GameScene(renderer_, window_, global_quit_, font_cache_, deck_);
+  deck_ = nullptr;
+  if (similarity_index_ != nullptr) {
+    game_scene->SetSimilarityIndex(similarity_index_);
+    similarity_index_ = nullptr;
+  }
+  if (long_rounds_) {
+    game_scene->UseLongRounds();
+  }
+  deck_file_is_watched_ = game_scene->WatchDeckFile(kEmscriptenInputFilePath);
+  return game_scene;
 
 }
 
+void LoadScene::PrewarmGame() {
+  scene_manager_->Preload(CreateGameScene());
+  game_is_prewarmed_ = true;
+}
+
+void LoadScene::DiscardPrewarmedGame() {
+
+  if (!game_is_prewarmed_) {
+    return;
+  }
+
+  // The deck went with the scene, so whoever discards it loads the file again if it is still needed
+  delete scene_manager_->TakeHeldScene<GameScene>();
+  game_is_prewarmed_ = false;
+
+}
+
+void LoadScene::RunOnEnter() {
+
+  // Each visit starts without a file, keeping only the mode settings
+  ClearLoadedFile();
+  ClearErrorMessage();
+  game_has_started_ = false;
+  load_button_event_ = NONE;
+  begin_button_event_ = NONE;
+  hard_rounds_button_event_ = NONE;
+  long_rounds_button_event_ = NONE;
+  typed_answers_button_event_ = NONE;
+  return_button_event_ = NONE;
+
+}
+
+void LoadScene::RunOnResume() {
+
+  // The loading scene should only be entered from the front; once the game it started is over, it leaves as well
+  if (game_has_started_) {
+    stop_following_file_edits();
+    QuitLocal();
+  }
+
+}
+
+bool LoadScene::IsReusable() {
+  return true;
+}
+
 void LoadScene::RunSingleIterationEventHandler(SDL_Event &event) {
 
   if (event.type == SDL_QUIT) {
@@ -214,49 +419,239 @@ void LoadScene::RunSingleIterationEventHandler(SDL_Event &event) {
   return_button_event_ = return_button_->HandleEvent(&event);
   load_button_event_ = load_button_->HandleEvent(&event);
   begin_button_event_ = begin_button_->HandleEvent(&event);
+  hard_rounds_button_event_ = hard_rounds_button_->HandleEvent(&event);
+  long_rounds_button_event_ = long_rounds_button_->HandleEvent(&event);
+  typed_answers_button_event_ = typed_answers_button_->HandleEvent(&event);
 
   if (return_button_event_ == PRESSED) {
+    DiscardPrewarmedGame();
     QuitLocal();
   }
 
   if (load_button_event_ == PRESSED) {
+    DiscardPrewarmedGame();
     loaded_file_has_been_processed_ = false;
+    begin_button_presented_ = false;
     AllocateLoadedFileName();
     ClearErrorMessage();
-    load_file(loaded_file_name_);
+    load_file(loaded_file_name_, kEmscriptenInputFilePath);
+  }
+
+  if (hard_rounds_button_event_ == PRESSED) {
+    hard_rounds_ = !hard_rounds_;
+    hard_rounds_button_->SetLabel(hard_rounds_ ? hard_rounds_on_text_ : hard_rounds_off_text_);
+    // A prewarmed round was drawn under the old setting
+    if (game_is_prewarmed_) {
+      LoadDeck();
+    } else if (hard_rounds_) {
+      BuildSimilarityIndex();
+    } else {
+      delete similarity_index_;
+      similarity_index_ = nullptr;
+    }
+  }
+
+  // The typed game asks one word at a time, so only the matching game has long rounds
+  if (long_rounds_button_event_ == PRESSED) {
+    long_rounds_ = !long_rounds_;
+    long_rounds_button_->SetLabel(long_rounds_ ? long_rounds_on_text_ : long_rounds_off_text_);
+    if (game_is_prewarmed_) {
+      LoadDeck();
+    }
   }
 
-  if (begin_button_event_ == PRESSED) {
+  if (typed_answers_button_event_ == PRESSED) {
+    typed_answers_ = !typed_answers_;
+    typed_answers_button_->SetLabel(typed_answers_ ? typed_answers_on_text_ : typed_answers_off_text_);
+    if (game_is_prewarmed_) {
+      LoadDeck();
+    } else if (typed_answers_) {
+      BuildWordTrie();
+    } else {
+      delete word_trie_;
+      word_trie_ = nullptr;
+    }
+  }
+
+  if (begin_button_event_ == PRESSED && IsFileReadyForGame()) {
     HandleBeginEvent(event);
   }
 
   if (IsFileLoaded() && !loaded_file_has_been_processed_) {
 
     ClearErrorMessage();
+    LoadDeck();
+    if (deck_ != nullptr) {
+      CheckGlyphCoverage();
+    }
+    loaded_file_has_been_processed_ = true;
+
+  }
+
+}
+
+void LoadScene::LoadDeck() {
 
-    printf("Processing file\n");
+  printf("Processing file\n");
+  Uint32 start_ticks = SDL_GetTicks();
+  unsigned int seed = (unsigned int) std::chrono::system_clock::now().time_since_epoch().count();
+
+  DiscardPrewarmedGame();
+  begin_button_presented_ = false;
+
+  delete similarity_index_;
+  similarity_index_ = nullptr;
+  delete word_trie_;
+  word_trie_ = nullptr;
+  delete deck_;
+  deck_ = nullptr;
+
+  // Plain files over the memory budget are never parsed whole: a line index is enough to start, and rounds parse
+  // only the lines they use. Skipping the cache here also skips hashing the whole file.
+  FileWordLoader *line_loader = new FileWordLoader(kEmscriptenInputFilePath);
+  if (line_loader->DetectCompression() == FileWordLoader::UNCOMPRESSED
+      && line_loader->GetFileSize() > deck_cache_.GetDeckMemoryBudgetBytes()) {
+
+    line_loader->SetLineIndexDirectory(kDeckCacheDirectory);
+    WordLoader::InputError input_error = line_loader->OpenLineIndex();
+    if (input_error != WordLoader::InputError::NONE) {
+      delete line_loader;
+      ShowInputError(input_error);
+      return;
+    }
+    deck_ = Deck::OpenLineIndexed(line_loader, seed, deck_cache_.GetDeckMemoryBudgetBytes());
+    SyncPersistentStorage();
+
+    printf("Deck of %d pairs ready in %d ms (line-indexed, %d KB resident)\n",
+           deck_->GetPairCount(),
+           (int) (SDL_GetTicks() - start_ticks),
+           (int) (deck_->GetResidentBytes() / 1024));
+    return;
+
+  }
+  delete line_loader;
+
+  uint64_t source_hash = 0;
+  if (!DeckCache::HashSourceFile(kEmscriptenInputFilePath, &source_hash)) {
+    ShowInputError(WordLoader::InputError::FILE_NOT_FOUND);
+    return;
+  }
+
+  // A file seen before was already parsed and validated, so its compiled deck is used as is
+  deck_ = deck_cache_.Find(source_hash, seed);
+  if (deck_ == nullptr) {
+
+    delete word_loader_;
     word_loader_ = new FileWordLoader(kEmscriptenInputFilePath);
     WordLoader::InputError input_error = word_loader_->ParseAndLoadIntoMap();
-
     if (input_error != WordLoader::InputError::NONE) {
-      switch (input_error) {
-        case WordLoader::InputError::LINE_CONTAINS_MORE_THAN_ONE_COMMA:
-          SetErrorMessage(
-              "A line exists in the file with more than one comma; each line must have one comma. Please try again.");
-          break;
-        case WordLoader::InputError::LINE_CONTAINS_NO_COMMA:
-          SetErrorMessage("A line exists in the file without a comma; each line must have one comma. Please try again.");
-          break;
-        case WordLoader::InputError::FILE_NOT_FOUND:
-          SetErrorMessage("File not found. Please try again.");
-          break;
-        default:
-          throw std::runtime_error(boost::str(boost::format("Unknown input error %1%") % input_error));
+      ShowInputError(input_error);
+      return;
+    }
+
+    deck_ = new Deck(word_loader_->GetWordPairMap(), seed);
+    // The parsed map is the largest copy of the deck; it is not needed once the deck is built
+    delete word_loader_;
+    word_loader_ = nullptr;
+
+    // A deck over the memory budget is swapped for a paged view of the copy just cached, so that its strings do not
+    // stay resident for the whole game
+    if (deck_cache_.Store(source_hash, deck_) && deck_->GetStringBytes() > deck_cache_.GetDeckMemoryBudgetBytes()) {
+      Deck *paged_deck = deck_cache_.Open(source_hash, seed);
+      if (paged_deck != nullptr) {
+        delete deck_;
+        deck_ = paged_deck;
       }
     }
+    SyncPersistentStorage();
 
-    loaded_file_has_been_processed_ = true;
+  }
+
+  printf("Deck of %d pairs ready in %d ms (%s, %d KB resident)\n",
+         deck_->GetPairCount(),
+         (int) (SDL_GetTicks() - start_ticks),
+         deck_->IsPaged() ? "paged" : "fully loaded",
+         (int) (deck_->GetResidentBytes() / 1024));
+
+  if (hard_rounds_) {
+    BuildSimilarityIndex();
+  }
+  if (typed_answers_) {
+    BuildWordTrie();
+  }
+
+}
+
+void LoadScene::BuildSimilarityIndex() {
+
+  // Indexing reads every word, which would defeat a deck that keeps only some of its pages resident
+  if (deck_ == nullptr || similarity_index_ != nullptr) {
+    return;
+  }
+  if (deck_->IsPaged()) {
+    printf("Hard rounds are only available for fully loaded decks\n");
+    return;
+  }
 
+  similarity_index_ = new SimilarityIndex(deck_);
+
+}
+
+void LoadScene::BuildWordTrie() {
+
+  // Unlike the similarity index, the trie keeps its own copy of the words, so paged decks are read through only once
+  if (deck_ == nullptr || word_trie_ != nullptr) {
+    return;
+  }
+
+  word_trie_ = new WordTrie(deck_);
+
+}
+
+void LoadScene::CheckGlyphCoverage() {
+
+  // Also picks the font the game draws the words from, so it is fetched, if need be, while the user is still here
+  font_cache_->CoverDeck(deck_);
+  std::vector<uint32_t> unrenderable = font_cache_->FindUnrenderableCodePoints();
+  if (unrenderable.empty()) {
+    return;
+  }
+
+  std::string examples;
+  for (std::size_t i = 0; i < unrenderable.size() && i < 3; i++) {
+    examples += boost::str(boost::format(" U+%|04X|") % unrenderable[i]);
+  }
+  printf("%d characters of the deck have no glyph in any bundled font:%s\n",
+         (int) unrenderable.size(),
+         examples.c_str());
+  SetWarningMessage(boost::str(boost::format("%1% characters in this file cannot be displayed, such as%2%; words "
+                                             "containing them will show boxes in their place.")
+                                   % unrenderable.size()
+                                   % examples));
+
+}
+
+void LoadScene::ShowInputError(WordLoader::InputError input_error) {
+
+  switch (input_error) {
+    case WordLoader::InputError::LINE_CONTAINS_MORE_THAN_ONE_COMMA:
+      SetErrorMessage(
+          "A line exists in the file with more than one comma; each line must have one comma. Please try again.");
+      break;
+    case WordLoader::InputError::LINE_CONTAINS_NO_COMMA:
+      SetErrorMessage("A line exists in the file without a comma; each line must have one comma. Please try again.");
+      break;
+    case WordLoader::InputError::FILE_NOT_FOUND:
+      SetErrorMessage("File not found. Please try again.");
+      break;
+    case WordLoader::InputError::UNSUPPORTED_COMPRESSION:
+      SetErrorMessage("Zstandard-compressed files are not supported; please use a plain or gzip-compressed file.");
+      break;
+    case WordLoader::InputError::CORRUPT_COMPRESSED_FILE:
+      SetErrorMessage("The compressed file is damaged or incomplete. Please try again.");
+      break;
+    default:
+      throw std::runtime_error(boost::str(boost::format("Unknown input error %1%") % input_error));
   }
 
 }
@@ -276,7 +671,8 @@ bool LoadScene::IsFileLoaded() {
 }
 
 bool LoadScene::IsFileReadyForGame() {
-  return IsFileLoaded() && loaded_file_has_been_processed_ && error_text_ == nullptr;
+  return IsFileLoaded() && loaded_file_has_been_processed_ && error_text_ == nullptr
+      && (deck_ != nullptr || game_is_prewarmed_);
 }
 
 bool LoadScene::IsErrorMessageSet() {
@@ -289,6 +685,9 @@ void LoadScene::RunSingleIterationLoopBody() {
   SDL_RenderClear(renderer_);
 
   load_button_->Render();
+  hard_rounds_button_->Render();
+  long_rounds_button_->Render();
+  typed_answers_button_->Render();
   return_button_->Render();
   explanation_text_->Render();
 
@@ -299,9 +698,19 @@ void LoadScene::RunSingleIterationLoopBody() {
   if (IsErrorMessageSet()) {
     error_text_->Render();
   }
+  if (warning_text_ != nullptr) {
+    warning_text_->Render();
+  }
 
   SDL_RenderPresent(renderer_);
 
+  // Begin has been on screen for a frame and the user is yet to click it, which leaves time to build the first round.
+  // The typed game is left to be built on the click, as it starts text input as soon as it is prepared.
+  if (begin_button_presented_ && !game_is_prewarmed_ && !typed_answers_ && deck_ != nullptr) {
+    PrewarmGame();
+  }
+  begin_button_presented_ = IsFileReadyForGame();
+
 }
 
 }
\ No newline at end of file
@@ -1,10 +1,13 @@
+#include <chrono>
+#include <cstdio>
 #include "scene/scene.h"
-#include <emscripten.h>
+#include "scene/scene_manager.h"
 
 namespace cross_language_match {
 
-Scene::Scene(SDL_Renderer *renderer, SDL_Window *window, bool &global_quit)
-    : global_quit_(global_quit), renderer_(renderer), window_(window), local_quit_(false) {
+Scene::Scene(SDL_Renderer *renderer, SDL_Window *window, bool &global_quit, FontCache *font_cache)
+    : global_quit_(global_quit), renderer_(renderer), window_(window), local_quit_(false), font_cache_(font_cache) {
+  SDL_GetWindowSize(window_, &screen_width_, &screen_height_);
 }
 
 Scene::~Scene() {
@@ -12,35 +15,115 @@ Scene::~Scene() {
   window_ = nullptr;
 }
 
-void Scene::Run() {
+bool Scene::RunSingleIteration() {
 
-  RunPreLoop();
+  // The window may have been resized while another scene was shown
+  UpdateLayout();
+  CollectPendingEvents();
 
-  SDL_Event event;
+  for (auto &event : pending_events_) {
+
+    if (global_quit_ || local_quit_ || scene_manager_->HasPendingScene()) {
+      return false;
+    }
 
-  while (!global_quit_ && !local_quit_) {
+    // Events after a resize are hit-tested against the new layout
+    if (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED) {
+      UpdateLayout();
+    }
 
-    while (SDL_PollEvent(&event)) {
+    RunSingleIterationEventHandler(event);
+    dispatched_event_count_++;
+  }
 
-      if (global_quit_ || local_quit_) {
-        return;
-      }
+  if (global_quit_ || local_quit_ || scene_manager_->HasPendingScene()) {
+    return false;
+  }
 
-      RunSingleIterationEventHandler(event);
-    }
+  RunSingleIterationLoopBody();
+  return true;
 
-    if (global_quit_ || local_quit_) {
-      return;
+}
+
+void Scene::CollectPendingEvents() {
+
+  pending_events_.clear();
+
+  SDL_Event event;
+  while (SDL_PollEvent(&event)) {
+
+    raw_event_count_++;
+
+    // Handlers read the live cursor position through SDL_GetMouseState, so a run of consecutive motion events carries
+    // no more information than its latest entry; collapse the run into that entry, keeping the accumulated relative
+    // motion. Button and other events are never merged, so their order is preserved.
+    if (event.type == SDL_MOUSEMOTION && !pending_events_.empty() && pending_events_.back().type == SDL_MOUSEMOTION) {
+      SDL_MouseMotionEvent &latest_motion = pending_events_.back().motion;
+      int accumulated_xrel = latest_motion.xrel + event.motion.xrel;
+      int accumulated_yrel = latest_motion.yrel + event.motion.yrel;
+      latest_motion = event.motion;
+      latest_motion.xrel = accumulated_xrel;
+      latest_motion.yrel = accumulated_yrel;
+      continue;
     }
 
-    RunSingleIterationLoopBody();
+    pending_events_.push_back(event);
 
-    emscripten_sleep(100);
+  }
+
+}
 
+void Scene::UpdatePixelScale(SDL_Renderer *renderer, SDL_Window *window) {
+
+  int window_width;
+  int output_width;
+  SDL_GetWindowSize(window, &window_width, nullptr);
+  if (SDL_GetRendererOutputSize(renderer, &output_width, nullptr) != 0 || window_width <= 0 || output_width <= 0) {
+    return;
+  }
+
+  // Text checks the scale as it is drawn, and is rasterized again when it has changed
+  float pixel_scale = (float) output_width / (float) window_width;
+  float current_pixel_scale;
+  SDL_RenderGetScale(renderer, &current_pixel_scale, nullptr);
+  if (pixel_scale != current_pixel_scale) {
+    SDL_RenderSetScale(renderer, pixel_scale, pixel_scale);
+    printf("Drawing at %.2f pixels per window coordinate\n", pixel_scale);
+  }
+
+}
+
+void Scene::UpdateLayout() {
+
+  UpdatePixelScale(renderer_, window_);
+
+  int screen_width;
+  int screen_height;
+  SDL_GetWindowSize(window_, &screen_width, &screen_height);
+  if (laid_out_ && screen_width == screen_width_ && screen_height == screen_height_) {
+    return;
   }
 
-  RunPostLoop();
+  auto start_time = std::chrono::steady_clock::now();
+  screen_width_ = screen_width;
+  screen_height_ = screen_height;
+  laid_out_ = true;
+  RunLayout();
+
+  printf("Laid out %s for %dx%d in %.3f ms\n",
+         GetSceneName(),
+         screen_width_,
+         screen_height_,
+         std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count());
+
+}
+
+long Scene::GetRawEventCount() {
+  return raw_event_count_;
+}
 
+long Scene::GetDispatchedEventCount() {
+  return dispatched_event_count_;
 }
 
 void Scene::QuitLocal() {
@@ -0,0 +1,201 @@
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+#include "scene/scene_manager.h"
+#include <emscripten.h>
+
+namespace cross_language_match {
+
+// Resumes the game at the browser's next frame, which comes at the display's refresh rate
+EM_ASYNC_JS(
+    void,
+    wait_for_animation_frame,
+    (),
+    {
+      await new Promise(resolve => requestAnimationFrame(resolve));
+    }
+);
+
+SceneManager::SceneManager(bool &global_quit) : global_quit_(global_quit) {}
+
+SceneManager::~SceneManager() {
+
+  // Scenes higher on the stack were created later and may depend on the ones below, so they go first
+  delete pending_scene_;
+  pending_scene_ = nullptr;
+
+  while (!scenes_.empty()) {
+    Scene *scene = scenes_.back();
+    scenes_.pop_back();
+    Discard(scene);
+  }
+
+  // A scene being discarded may take back a scene it preloaded, so the held scenes are not iterated over
+  while (!held_scenes_.empty()) {
+    Scene *scene = held_scenes_.back();
+    held_scenes_.pop_back();
+    Discard(scene);
+  }
+
+}
+
+void SceneManager::Push(Scene *scene) {
+
+  if (pending_scene_ != nullptr) {
+    throw std::runtime_error("Only one scene can be pushed per event");
+  }
+
+  StartTransitionTiming();
+  scene->scene_manager_ = this;
+  pending_scene_ = scene;
+
+}
+
+bool SceneManager::HasPendingScene() {
+  return pending_scene_ != nullptr;
+}
+
+void SceneManager::Preload(Scene *scene) {
+
+  auto start_time = std::chrono::steady_clock::now();
+  scene->scene_manager_ = this;
+  Prepare(scene);
+  held_scenes_.push_back(scene);
+
+  printf("Preloaded %s in %.1f ms\n",
+         scene->GetSceneName(),
+         std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count());
+
+}
+
+void SceneManager::Run() {
+
+  ApplyTransitions();
+
+  while (!global_quit_ && !scenes_.empty()) {
+
+    // A scene can also push or quit while drawing, in which case its frame does not end the transition
+    Scene *scene = scenes_.back();
+    if (scene->RunSingleIteration() && pending_scene_ == nullptr && !scene->local_quit_) {
+      ReportTransitionTiming();
+    }
+
+    // After a transition the next scene draws its first frame straight away rather than after the usual pause
+    if (ApplyTransitions()) {
+      continue;
+    }
+
+    // Scenes at rest are only drawn again every so often; one that is animating is drawn every display frame
+    if (scene->IsAnimating()) {
+      wait_for_animation_frame();
+    } else {
+      emscripten_sleep(100);
+    }
+
+  }
+
+}
+
+bool SceneManager::ApplyTransitions() {
+
+  bool applied = false;
+  bool changed = true;
+  while (changed) {
+
+    changed = false;
+
+    // A scene that quits and pushes in the same event is replaced rather than covered
+    if (!scenes_.empty() && scenes_.back()->local_quit_) {
+      StartTransitionTiming();
+      Scene *scene = scenes_.back();
+      scenes_.pop_back();
+      if (scene->IsReusable()) {
+        held_scenes_.push_back(scene);
+      } else {
+        Discard(scene);
+      }
+      if (!scenes_.empty() && pending_scene_ == nullptr) {
+        scenes_.back()->RunOnResume();
+      }
+      changed = true;
+    }
+
+    if (pending_scene_ != nullptr) {
+      Scene *scene = pending_scene_;
+      pending_scene_ = nullptr;
+      if (!scene->prepared_) {
+        auto start_time = std::chrono::steady_clock::now();
+        Prepare(scene);
+        transition_preparation_ms_ +=
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+      }
+      scene->local_quit_ = false;
+      scenes_.push_back(scene);
+      scene->RunOnEnter();
+      changed = true;
+    }
+
+    applied = applied || changed;
+
+  }
+
+  return applied;
+
+}
+
+void SceneManager::Prepare(Scene *scene) {
+  scene->RunPreLoop();
+  scene->prepared_ = true;
+}
+
+void SceneManager::Discard(Scene *scene) {
+
+  printf("%s received %ld raw events and dispatched %ld\n",
+         scene->GetSceneName(),
+         scene->GetRawEventCount(),
+         scene->GetDispatchedEventCount());
+
+  if (scene->prepared_) {
+    scene->RunPostLoop();
+  }
+  delete scene;
+
+}
+
+void SceneManager::StartTransitionTiming() {
+
+  if (transition_is_timed_) {
+    return;
+  }
+
+  transition_is_timed_ = true;
+  transition_start_time_ = std::chrono::steady_clock::now();
+  transition_from_ = scenes_.empty() ? "nothing" : scenes_.back()->GetSceneName();
+  transition_preparation_ms_ = 0;
+
+}
+
+void SceneManager::ReportTransitionTiming() {
+
+  if (!transition_is_timed_) {
+    return;
+  }
+
+  transition_is_timed_ = false;
+  double elapsed_ms =
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - transition_start_time_).count();
+  printf("Transition from %s to %s took %.1f ms to the first frame (%.1f ms preparing scenes that were not ready)\n",
+         transition_from_.c_str(),
+         scenes_.back()->GetSceneName(),
+         elapsed_ms,
+         transition_preparation_ms_);
+
+  // Includes downloading the game itself and every asset fetched before the first scene was shown
+  if (!first_frame_reported_) {
+    first_frame_reported_ = true;
+    printf("First frame presented %.1f ms after the page began loading\n", emscripten_get_now());
+  }
+
+}
+
+}
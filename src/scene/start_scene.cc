@@ -1,49 +1,31 @@
+#include <chrono>
 #include <boost/format.hpp>
 #include "button/labeled_button.h"
 #include "scene/load_scene.h"
 #include "scene/start_scene.h"
 #include "scene/game_scene.h"
 #include "scene/help_scene.h"
+#include "scene/scene_manager.h"
+#include "storage/persistent_storage.h"
+#include "storage/session_snapshot.h"
 
 namespace cross_language_match {
 
 StartScene::StartScene(SDL_Renderer *renderer,
                        SDL_Window *window,
                        bool &global_quit,
-                       int screen_height,
-                       int screen_width)
-    : Scene(renderer, window, global_quit),
-      screen_height_(screen_height),
-      screen_width_(screen_width) {
-
-  if (TTF_Init() == -1) {
-    throw std::runtime_error(
-        boost::str(boost::format("SDL_ttf could not be initialized, error: %1%\n") % TTF_GetError())
-    );
-  }
+                       FontCache *font_cache)
+    : Scene(renderer, window, global_quit, font_cache) {
 
-  button_font_ = TTF_OpenFont("assets/fonts/OpenSans-Regular.ttf", button_font_size_);
-  if (button_font_ == nullptr) {
-    throw std::runtime_error(boost::str(boost::format("Failed to load font, error: %1%\n") % TTF_GetError()));
-  }
+  // The title font is the first asset the game needs, so it is opened, and the font file fetched, before any other
+  title_font_ = font_cache_->GetFont(title_font_size_);
 
-  title_font_ = TTF_OpenFont("assets/fonts/OpenSans-Regular.ttf", title_font_size_);
-  if (title_font_ == nullptr) {
-    throw std::runtime_error(boost::str(boost::format("Failed to load font, error: %1%\n") % TTF_GetError()));
-  }
+  button_font_ = font_cache_->GetFont(button_font_size_);
 
 }
 
-StartScene::~StartScene() {
-
-  TTF_CloseFont(button_font_);
-  button_font_ = nullptr;
-
-  TTF_CloseFont(title_font_);
-  title_font_ = nullptr;
-
-  TTF_Quit();
-
+const char *StartScene::GetSceneName() {
+  return "StartScene";
 }
 
 void StartScene::RunPreLoop() {
@@ -61,8 +43,18 @@ void StartScene::RunPreLoop() {
       new LabeledButton(RectangularButton(Rectangle(renderer_, button_width_, button_height_)), help_text_);
   help_button_event_ = NONE;
 
+  resume_text_ = new Text(renderer_, button_font_, start_text_color_, "Resume the game");
+  resume_button_ =
+      new LabeledButton(RectangularButton(Rectangle(renderer_, button_width_, button_height_)), resume_text_);
+  resume_button_event_ = NONE;
+  session_can_be_resumed_ = SessionSnapshot(kPersistentStorageDirectory).Exists();
+
   title_text_ = new Text(renderer_, title_font_, title_text_color_, "Cross Language Match");
 
+}
+
+void StartScene::RunLayout() {
+
   // Render the game title in the top middle
   title_text_->SetTopLeftPosition(screen_width_ / 2 - title_text_->GetWidth() / 2,
                                   title_text_->GetHeight() + 100);
@@ -75,6 +67,10 @@ void StartScene::RunPreLoop() {
   start_button_->SetTopLeftPosition(screen_width_ / 2 - start_button_->GetWidth() / 2,
                                     help_button_->GetTopLeftY() + help_button_->GetHeight() + 10);
 
+  // Render the resume button below the start button
+  resume_button_->SetTopLeftPosition(screen_width_ / 2 - resume_button_->GetWidth() / 2,
+                                     start_button_->GetTopLeftY() + start_button_->GetHeight() + 10);
+
 }
 
 void StartScene::RunPostLoop() {
@@ -91,11 +87,18 @@ void StartScene::RunPostLoop() {
   delete help_button_;
   help_button_ = nullptr;
 
+  delete resume_text_;
+  resume_text_ = nullptr;
+
+  delete resume_button_;
+  resume_button_ = nullptr;
+
   delete title_text_;
   title_text_ = nullptr;
 
   start_button_event_ = NONE;
   help_button_event_ = NONE;
+  resume_button_event_ = NONE;
 
 }
 
@@ -107,18 +110,28 @@ void StartScene::RunSingleIterationEventHandler(SDL_Event &event) {
 
   help_button_event_ = help_button_->HandleEvent(&event);
   start_button_event_ = start_button_->HandleEvent(&event);
+  resume_button_event_ = session_can_be_resumed_ ? resume_button_->HandleEvent(&event) : NONE;
 
   if (start_button_event_ == PRESSED) {
 
-    LoadScene
-        load_scene = LoadScene(renderer_, window_, global_quit_, screen_height_, screen_width_);
-    load_scene.Run();
+    LoadScene *load_scene = scene_manager_->TakeHeldScene<LoadScene>();
+    if (load_scene == nullptr) {
+      load_scene = new LoadScene(renderer_, window_, global_quit_, font_cache_);
+    }
+    scene_manager_->Push(load_scene);
+
+  } else if (resume_button_event_ == PRESSED) {
+
+    ResumeSession();
 
   } else if (help_button_event_ == PRESSED) {
 
     printf("Help button pressed. Going into help menu\n");
-    HelpScene help_scene = HelpScene(renderer_, window_, global_quit_, screen_height_, screen_width_);
-    help_scene.Run();
+    HelpScene *help_scene = scene_manager_->TakeHeldScene<HelpScene>();
+    if (help_scene == nullptr) {
+      help_scene = new HelpScene(renderer_, window_, global_quit_, font_cache_);
+    }
+    scene_manager_->Push(help_scene);
 
   }
 
@@ -126,13 +139,68 @@ void StartScene::RunSingleIterationEventHandler(SDL_Event &event) {
 
 void StartScene::RunSingleIterationLoopBody() {
 
+  // Preparing them before the menu's first frame would delay it
+  if (first_frame_presented_) {
+    PreloadNextScenes();
+  }
+  first_frame_presented_ = true;
+
   SDL_SetRenderDrawColor(renderer_, background_color_.r, background_color_.g, background_color_.b, background_color_.a);
   SDL_RenderClear(renderer_);
   start_button_->Render();
   help_button_->Render();
+  if (session_can_be_resumed_) {
+    resume_button_->Render();
+  }
   title_text_->Render();
   SDL_RenderPresent(renderer_);
 
 }
 
+void StartScene::RunOnResume() {
+  // The scene above may have finished, saved or discarded a game
+  session_can_be_resumed_ = SessionSnapshot(kPersistentStorageDirectory).Exists();
+}
+
+void StartScene::PreloadNextScenes() {
+
+  // Both are reusable, so once preloaded they are held between visits and only need preparing once
+  if (!scene_manager_->IsHoldingScene<LoadScene>()) {
+    scene_manager_->Preload(new LoadScene(renderer_, window_, global_quit_, font_cache_));
+  }
+  if (!scene_manager_->IsHoldingScene<HelpScene>()) {
+    scene_manager_->Preload(new HelpScene(renderer_, window_, global_quit_, font_cache_));
+  }
+
+}
+
+void StartScene::ResumeSession() {
+
+  Uint32 start_ticks = SDL_GetTicks();
+  SessionSnapshot session_snapshot(kPersistentStorageDirectory);
+
+  // The compiled deck is loaded directly, so the word file is never parsed again
+  Deck *deck = session_snapshot.ReadDeck((unsigned int) std::chrono::system_clock::now().time_since_epoch().count());
+  if (deck == nullptr) {
+    printf("Saved session has no usable deck; discarding it\n");
+    session_snapshot.Clear();
+    session_can_be_resumed_ = false;
+    return;
+  }
+
+  // The saved deck's characters decide which font its words are drawn from
+  font_cache_->CoverDeck(deck);
+  GameScene *game_scene = new GameScene(renderer_, window_, global_quit_, font_cache_, deck);
+  if (!game_scene->RestoreSession()) {
+    delete game_scene;
+    session_snapshot.Clear();
+    session_can_be_resumed_ = false;
+    return;
+  }
+
+  printf("Resumed session with %d pairs in %d ms\n", deck->GetPairCount(), (int) (SDL_GetTicks() - start_ticks));
+  scene_manager_->Push(game_scene);
+
+}
+
 }
\ No newline at end of file
@@ -0,0 +1,547 @@
+#include <algorithm>
+#include <chrono>
+#include <SDL2/SDL.h>
+#include <boost/format.hpp>
+#include "scene/typed_game_scene.h"
+#include "button/rectangular_button.h"
+#include "storage/persistent_storage.h"
+
+namespace cross_language_match {
+
+TypedGameScene::TypedGameScene(SDL_Renderer *renderer,
+                               SDL_Window *window,
+                               bool &global_quit,
+                               FontCache *font_cache,
+                               Deck *deck,
+                               WordTrie *word_trie)
+    : Scene(renderer, window, global_quit, font_cache),
+      deck_(deck),
+      word_trie_(word_trie),
+      // Every right word of the deck must fit, or its pair could never be answered correctly
+      max_answer_bytes_(std::max((int) kMinAnswerCapacityBytes, word_trie->GetMaxWordLength())) {
+
+  font_ = font_cache_->GetFont(font_size_);
+  word_font_chain_ = font_cache_->GetWordFontChain(font_size_);
+
+  scheduler_ = new LeitnerScheduler(deck_);
+
+  attempt_log_ = new AttemptLog(kPersistentStorageDirectory);
+  LoadAttemptHistory();
+
+  answer_.reserve(max_answer_bytes_);
+  answer_positions_.reserve(max_answer_bytes_ + 1);
+  answer_positions_.push_back(WordTrie::GetRootPosition());
+
+}
+
+TypedGameScene::~TypedGameScene() {
+
+  // The scene manager has usually run the post loop already; a scene torn down while still shown, which still has its
+  // hint, runs it here so that buffered attempts are written out while the attempt log exists
+  if (hint_text_ != nullptr) {
+    RunPostLoop();
+  }
+  CleanRound();
+
+  delete scheduler_;
+  scheduler_ = nullptr;
+
+  delete similarity_index_;
+  similarity_index_ = nullptr;
+
+  delete attempt_log_;
+  attempt_log_ = nullptr;
+
+  delete word_trie_;
+  word_trie_ = nullptr;
+
+  delete deck_;
+  deck_ = nullptr;
+
+}
+
+void TypedGameScene::SetSimilarityIndex(SimilarityIndex *similarity_index) {
+  delete similarity_index_;
+  similarity_index_ = similarity_index;
+  scheduler_->SetSimilarityIndex(similarity_index_);
+}
+
+const char *TypedGameScene::GetSceneName() {
+  return "TypedGameScene";
+}
+
+void TypedGameScene::RunPreLoop() {
+
+  SDL_SetRenderDrawColor(renderer_, background_color_.r, background_color_.g, background_color_.b, background_color_.a);
+  SDL_RenderClear(renderer_);
+
+  hint_text_ = new Text(renderer_, font_, suggestion_text_color_, "Type the translation, then press Enter");
+  incorrect_text_ = new Text(renderer_, font_, plain_text_color_, "Incorrect; please try again.");
+  correct_text_ = new Text(renderer_, font_, plain_text_color_, "Correct - well done!");
+
+  next_round_text_ = new Text(renderer_, font_, button_text_color_, "Next Round");
+  next_round_button_ =
+      new LabeledButton(RectangularButton(Rectangle(renderer_, button_width_, button_height_)), next_round_text_);
+  return_text_ = new Text(renderer_, font_, button_text_color_, "Main Menu");
+  return_button_ =
+      new LabeledButton(RectangularButton(Rectangle(renderer_, button_width_, button_height_)), return_text_);
+  next_round_button_event_ = NONE;
+  return_button_event_ = NONE;
+
+  SDL_StartTextInput();
+  PrepareRound();
+
+}
+
+void TypedGameScene::RunLayout() {
+
+  // Next round button is in the bottom right, and the return button in the bottom left
+  next_round_button_->SetTopLeftPosition(screen_width_ - 10 - next_round_button_->GetWidth(),
+                                         screen_height_ - next_round_button_->GetHeight() - 10);
+  return_button_->SetTopLeftPosition(10, screen_height_ - return_button_->GetHeight() - 10);
+
+  // Correct or incorrect message should be rendered in the bottom middle
+  correct_text_->SetTopLeftPosition(screen_width_ / 2 - correct_text_->GetWidth() / 2,
+                                    screen_height_ - correct_text_->GetHeight() - 10);
+  incorrect_text_->SetTopLeftPosition(screen_width_ / 2 - incorrect_text_->GetWidth() / 2,
+                                      screen_height_ - incorrect_text_->GetHeight() - 10);
+
+  PositionPromptLines();
+  if (progress_text_ != nullptr) {
+    PositionProgressText();
+  }
+
+}
+
+void TypedGameScene::RunPostLoop() {
+
+  SDL_StopTextInput();
+
+  if (max_keystroke_us_ > 0) {
+    printf("Slowest keystroke took %.1f us in the trie\n", max_keystroke_us_);
+  }
+  font_cache_->GetShapedTextCache()->PrintStats();
+
+  if (attempt_log_ != nullptr) {
+    attempt_log_->Flush();
+    attempt_log_->CompactIfNeeded();
+    SyncPersistentStorage();
+  }
+
+  delete prompt_text_;
+  prompt_text_ = nullptr;
+
+  delete answer_text_;
+  answer_text_ = nullptr;
+
+  delete hint_text_;
+  hint_text_ = nullptr;
+
+  delete progress_text_;
+  progress_text_ = nullptr;
+
+  delete incorrect_text_;
+  incorrect_text_ = nullptr;
+
+  delete correct_text_;
+  correct_text_ = nullptr;
+
+  for (auto &suggestion_text : suggestion_texts_) {
+    delete suggestion_text;
+    suggestion_text = nullptr;
+  }
+  suggestion_count_ = 0;
+
+  delete next_round_text_;
+  next_round_text_ = nullptr;
+
+  delete next_round_button_;
+  next_round_button_ = nullptr;
+
+  delete return_text_;
+  return_text_ = nullptr;
+
+  delete return_button_;
+  return_button_ = nullptr;
+
+  next_round_button_event_ = NONE;
+  return_button_event_ = NONE;
+
+}
+
+void TypedGameScene::RunSingleIterationEventHandler(SDL_Event &event) {
+
+  if (event.type == SDL_QUIT) {
+    QuitGlobal();
+  }
+
+  bool answering = !current_round_is_complete_ && !current_pair_indices_.empty();
+  bool next_round_requested = false;
+
+  if (event.type == SDL_TEXTINPUT && answering) {
+    AppendAnswerBytes(event.text.text);
+  }
+
+  if (event.type == SDL_KEYDOWN) {
+    switch (event.key.keysym.sym) {
+      case SDLK_BACKSPACE:
+        if (answering) {
+          RemoveAnswerCharacter();
+        }
+        break;
+      case SDLK_TAB:
+        if (answering) {
+          AcceptFirstSuggestion();
+        }
+        break;
+      case SDLK_RETURN:
+      case SDLK_KP_ENTER:
+        if (answering) {
+          SubmitAnswer();
+        } else {
+          next_round_requested = true;
+        }
+        break;
+      default:
+        break;
+    }
+  }
+
+  next_round_button_event_ = next_round_button_->HandleEvent(&event);
+  if (next_round_button_event_ == PRESSED) {
+    next_round_requested = true;
+  }
+  // The button is only shown once the round is complete, and every pair of the round must have its result recorded
+  // with the scheduler before the next round is selected
+  if (next_round_requested && current_round_is_complete_) {
+    if (all_rounds_complete_) {
+      QuitLocal();
+    } else {
+      PrepareRound();
+    }
+  }
+
+  return_button_event_ = return_button_->HandleEvent(&event);
+  if (return_button_event_ == PRESSED) {
+    QuitLocal();
+  }
+
+}
+
+void TypedGameScene::RunSingleIterationLoopBody() {
+
+  SDL_SetRenderDrawColor(renderer_, background_color_.r, background_color_.g, background_color_.b, background_color_.a);
+  SDL_RenderClear(renderer_);
+
+  progress_text_->Render();
+  if (!current_round_is_complete_) {
+    prompt_text_->Render();
+    if (!answer_.empty()) {
+      answer_text_->Render();
+    } else {
+      hint_text_->Render();
+    }
+    for (int i = 0; i < suggestion_count_; i++) {
+      suggestion_texts_[i]->Render();
+    }
+  }
+
+  return_button_->Render();
+
+  if (current_round_is_complete_) {
+    next_round_button_->Render();
+    correct_text_->Render();
+  } else if (last_answer_was_incorrect_) {
+    incorrect_text_->Render();
+  }
+
+  SDL_RenderPresent(renderer_);
+
+}
+
+void TypedGameScene::PrepareRound() {
+
+  CleanRound();
+
+  auto start_time = std::chrono::steady_clock::now();
+  int selected_count = scheduler_->SelectRound(pairs_per_round_, &current_pair_indices_);
+  double select_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+  printf("Round %d: selected %d pairs (%d awaiting review, %d unseen) in %.3f ms\n",
+         scheduler_->GetCurrentRound(),
+         selected_count,
+         scheduler_->GetReviewCount(),
+         deck_->GetRemainingCount(),
+         select_ms);
+
+  round_error_counts_.assign(current_pair_indices_.size(), 0);
+  current_prompt_ = 0;
+  current_round_is_complete_ = false;
+  last_answer_was_incorrect_ = false;
+
+  // Only an empty deck has nothing to ask
+  if (current_pair_indices_.empty()) {
+    current_round_is_complete_ = true;
+    all_rounds_complete_ = true;
+    UpdateProgressText();
+    return;
+  }
+
+  ShowPrompt();
+
+}
+
+void TypedGameScene::ShowPrompt() {
+
+  delete prompt_text_;
+  int pair_index = current_pair_indices_[current_prompt_];
+  prompt_text_ = new Text(renderer_, word_font_chain_, plain_text_color_, deck_->GetLeftWord(pair_index));
+  PositionPromptLines();
+
+  prompt_start_ticks_ = SDL_GetTicks();
+  ClearAnswer();
+  UpdateProgressText();
+
+}
+
+void TypedGameScene::PositionPromptLines() {
+
+  if (prompt_text_ == nullptr) {
+    return;
+  }
+  prompt_text_->SetTopLeftPosition(screen_width_ / 2 - prompt_text_->GetWidth() / 2, screen_height_ / 4);
+
+  // The answer and its suggestions are laid out in lines below the prompt, as tall as the hint
+  int answer_y = prompt_text_->GetTopLeftY() + prompt_text_->GetHeight() + padding_lines_ * 2;
+  hint_text_->SetTopLeftPosition(screen_width_ / 2 - hint_text_->GetWidth() / 2, answer_y);
+  if (answer_text_ != nullptr) {
+    answer_text_->SetTopLeftPosition(screen_width_ / 2 - answer_text_->GetWidth() / 2, answer_y);
+  }
+
+  int y = answer_y + hint_text_->GetHeight() + padding_lines_;
+  for (int i = 0; i < suggestion_count_; i++) {
+    suggestion_texts_[i]->SetTopLeftPosition(screen_width_ / 2 - suggestion_texts_[i]->GetWidth() / 2, y);
+    y += suggestion_texts_[i]->GetHeight();
+  }
+
+}
+
+void TypedGameScene::AppendAnswerBytes(const char *bytes) {
+
+  auto start_time = std::chrono::steady_clock::now();
+
+  // Once a byte has no match, no longer answer can have one either
+  for (; *bytes != '\0' && (int) answer_.size() < max_answer_bytes_; bytes++) {
+    WordTrie::Position position = answer_positions_.back();
+    if (unmatched_byte_count_ == 0 && word_trie_->Advance(&position, *bytes)) {
+      answer_positions_.push_back(position);
+    } else {
+      unmatched_byte_count_++;
+    }
+    answer_.push_back(*bytes);
+  }
+
+  FinishKeystroke(start_time);
+
+}
+
+void TypedGameScene::RemoveAnswerCharacter() {
+
+  if (answer_.empty()) {
+    return;
+  }
+
+  auto start_time = std::chrono::steady_clock::now();
+
+  // Text input arrives as whole UTF-8 characters, so a character's continuation bytes go with its leading byte
+  unsigned char removed_byte;
+  do {
+    removed_byte = (unsigned char) answer_.back();
+    answer_.pop_back();
+    if (unmatched_byte_count_ > 0) {
+      unmatched_byte_count_--;
+    } else {
+      answer_positions_.pop_back();
+    }
+  } while ((removed_byte & 0xC0) == 0x80 && !answer_.empty());
+
+  FinishKeystroke(start_time);
+
+}
+
+void TypedGameScene::AcceptFirstSuggestion() {
+
+  // Every suggestion starts with the answer so far, so only the rest of it is typed in
+  if (suggestion_count_ > 0) {
+    AppendAnswerBytes(word_trie_->GetWord(suggestions_[0]) + answer_.size());
+  }
+
+}
+
+void TypedGameScene::ClearAnswer() {
+
+  answer_.clear();
+  answer_positions_.resize(1);
+  unmatched_byte_count_ = 0;
+  last_answer_was_incorrect_ = false;
+
+  if (FindSuggestions()) {
+    RenderSuggestions();
+  }
+  UpdateAnswerText();
+
+}
+
+void TypedGameScene::FinishKeystroke(std::chrono::steady_clock::time_point start_time) {
+
+  // Only the trie's share of the keystroke is timed; rasterizing the answer is the same whatever the deck size
+  bool suggestions_changed = FindSuggestions();
+  double elapsed_us =
+      std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start_time).count();
+  max_keystroke_us_ = std::max(max_keystroke_us_, elapsed_us);
+
+  if (suggestions_changed) {
+    RenderSuggestions();
+  }
+  UpdateAnswerText();
+
+}
+
+bool TypedGameScene::FindSuggestions() {
+
+  int found[kSuggestionCount];
+  int found_count = 0;
+  if (!answer_.empty() && unmatched_byte_count_ == 0) {
+    found_count = word_trie_->GetCompletions(answer_positions_.back(), kSuggestionCount, found);
+  }
+
+  if (found_count == suggestion_count_ && std::equal(found, found + found_count, suggestions_)) {
+    return false;
+  }
+  std::copy(found, found + found_count, suggestions_);
+  suggestion_count_ = found_count;
+  return true;
+
+}
+
+void TypedGameScene::RenderSuggestions() {
+
+  for (int i = 0; i < kSuggestionCount; i++) {
+    delete suggestion_texts_[i];
+    suggestion_texts_[i] = nullptr;
+    if (i >= suggestion_count_) {
+      continue;
+    }
+    suggestion_texts_[i] =
+        new Text(renderer_, word_font_chain_, suggestion_text_color_, word_trie_->GetWord(suggestions_[i]));
+  }
+  PositionPromptLines();
+
+}
+
+void TypedGameScene::UpdateAnswerText() {
+
+  // An empty string cannot be rendered; the hint is shown in its place, and the text is left for the next answer
+  if (answer_.empty()) {
+    return;
+  }
+
+  if (answer_text_ == nullptr) {
+    answer_text_ = new Text(renderer_, word_font_chain_, plain_text_color_, answer_);
+  } else {
+    answer_text_->SetString(answer_);
+  }
+  PositionPromptLines();
+
+}
+
+void TypedGameScene::SubmitAnswer() {
+
+  if (answer_.empty()) {
+    return;
+  }
+
+  int pair_index = current_pair_indices_[current_prompt_];
+  bool correct = answer_ == deck_->GetRightWord(pair_index);
+  attempt_log_->Append(AttemptLog::GetPairKey(deck_->GetLeftWord(pair_index), deck_->GetRightWord(pair_index)),
+                       correct,
+                       std::max<Uint32>(SDL_GetTicks() - prompt_start_ticks_, 1));
+
+  if (!correct) {
+    printf("Incorrect; try again!\n");
+    round_error_counts_[current_prompt_]++;
+    last_answer_was_incorrect_ = true;
+    return;
+  }
+
+  current_prompt_++;
+  if (current_prompt_ < (int) current_pair_indices_.size()) {
+    ShowPrompt();
+    return;
+  }
+
+  printf("Correct! Preparing next set of words!\n");
+  current_round_is_complete_ = true;
+  RecordRoundResults();
+  UpdateProgressText();
+
+  if (scheduler_->IsComplete()) {
+    printf("Correct! Game is over! All words done!\n");
+    all_rounds_complete_ = true;
+  }
+
+}
+
+void TypedGameScene::UpdateProgressText() {
+
+  delete progress_text_;
+  progress_text_ = new Text(renderer_,
+                            font_,
+                            plain_text_color_,
+                            boost::str(boost::format("%1%/%2% answered")
+                                           % current_prompt_
+                                           % current_pair_indices_.size()));
+  PositionProgressText();
+
+}
+
+void TypedGameScene::PositionProgressText() {
+
+  // Progress is shown in the top middle
+  progress_text_->SetTopLeftPosition(screen_width_ / 2 - progress_text_->GetWidth() / 2, padding_lines_);
+
+}
+
+void TypedGameScene::RecordRoundResults() {
+  for (int i = 0; i < (int) current_pair_indices_.size(); i++) {
+    scheduler_->RecordResult(current_pair_indices_[i], round_error_counts_[i]);
+  }
+}
+
+void TypedGameScene::LoadAttemptHistory() {
+
+  attempt_history_ = attempt_log_->LoadStats();
+
+  // As in the linking game, history is matched against pairs only as they are drawn
+  scheduler_->SetHistoricalErrorSource([this](int pair_index) {
+    const PairStats *pair_stats =
+        AttemptLog::FindStats(attempt_history_, AttemptLog::GetPairKey(deck_->GetLeftWord(pair_index),
+                                                                       deck_->GetRightWord(pair_index)));
+    return pair_stats == nullptr ? 0 : (int) (pair_stats->attempt_count - pair_stats->correct_count);
+  });
+
+}
+
+void TypedGameScene::CleanRound() {
+
+  // Round boundaries are where buffered attempts are written out, as in the linking game
+  if (attempt_log_ != nullptr) {
+    attempt_log_->Flush();
+    SyncPersistentStorage();
+  }
+
+  current_pair_indices_.clear();
+  round_error_counts_.clear();
+
+}
+
+}
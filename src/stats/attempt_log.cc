@@ -0,0 +1,241 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "hash/fnv1a.h"
+#include "stats/attempt_log.h"
+
+namespace cross_language_match {
+
+static const char kLogMagic[] = "CLMLOG01";
+static const char kSnapshotMagic[] = "CLMSNP01";
+
+AttemptLog::AttemptLog(std::string directory)
+    : log_path_(directory + "/attempts.log"),
+      snapshot_path_(directory + "/attempts.snapshot") {
+
+  struct stat log_stat;
+  if (stat(log_path_.c_str(), &log_stat) != 0) {
+    return;
+  }
+
+  // An interrupted write can leave a torn record, or a torn magic, at the end of the log. Flush appends after
+  // whatever is there, so the log is cut back to whole records before anything else is written to it.
+  if (log_stat.st_size < (off_t) kMagicLength) {
+    remove(log_path_.c_str());
+    return;
+  }
+  log_record_count_ = (long) ((log_stat.st_size - kMagicLength) / sizeof(AttemptRecord));
+  off_t whole_size = (off_t) (kMagicLength + log_record_count_ * sizeof(AttemptRecord));
+  if (log_stat.st_size != whole_size && truncate(log_path_.c_str(), whole_size) != 0) {
+    printf("Warning: unable to drop a torn record from attempt log %s\n", log_path_.c_str());
+  }
+
+}
+
+AttemptLog::~AttemptLog() {
+  Flush();
+}
+
+void AttemptLog::Append(uint64_t pair_key, bool correct, uint32_t time_to_link_ms) {
+  pending_records_.push_back({pair_key, time_to_link_ms, correct ? 1u : 0u});
+}
+
+void AttemptLog::Flush() {
+
+  if (pending_records_.empty()) {
+    return;
+  }
+
+  FILE *file = fopen(log_path_.c_str(), "ab");
+  if (file == nullptr) {
+    printf("Warning: unable to open attempt log %s; keeping %d records in memory\n",
+           log_path_.c_str(),
+           (int) pending_records_.size());
+    return;
+  }
+
+  // An append stream can report position 0 until its first write, as musl's does, so the end is sought explicitly
+  fseek(file, 0, SEEK_END);
+  if (ftell(file) == 0) {
+    fwrite(kLogMagic, 1, kMagicLength, file);
+  }
+  std::size_t written = fwrite(pending_records_.data(), sizeof(AttemptRecord), pending_records_.size(), file);
+  fclose(file);
+
+  log_record_count_ += (long) written;
+  pending_records_.clear();
+
+}
+
+void AttemptLog::CompactIfNeeded() {
+  if (log_record_count_ >= kCompactionThreshold) {
+    Compact();
+  }
+}
+
+void AttemptLog::Compact() {
+
+  Flush();
+
+  std::vector<PairStats> stats = LoadStats();
+  if (!WriteSnapshot(stats)) {
+    return;
+  }
+
+  // The snapshot now covers everything in the log, so the log starts over
+  remove(log_path_.c_str());
+  log_record_count_ = 0;
+
+}
+
+std::vector<PairStats> AttemptLog::LoadStats() {
+
+  std::vector<PairStats> snapshot = ReadSnapshot();
+  std::vector<AttemptRecord> records = ReadLog();
+  records.insert(records.end(), pending_records_.begin(), pending_records_.end());
+
+  std::sort(records.begin(), records.end(), [](const AttemptRecord &a, const AttemptRecord &b) {
+    return a.pair_key < b.pair_key;
+  });
+
+  // Fold the sorted records into per-pair totals, then merge those with the already sorted snapshot
+  std::vector<PairStats> log_stats;
+  for (auto &record : records) {
+    if (log_stats.empty() || log_stats.back().pair_key != record.pair_key) {
+      log_stats.push_back({record.pair_key, 0, 0, 0});
+    }
+    log_stats.back().attempt_count++;
+    log_stats.back().correct_count += record.correct;
+    log_stats.back().total_time_to_link_ms += record.time_to_link_ms;
+  }
+
+  std::vector<PairStats> stats;
+  stats.reserve(snapshot.size() + log_stats.size());
+  auto snapshot_entry = snapshot.begin();
+  auto log_entry = log_stats.begin();
+  while (snapshot_entry != snapshot.end() || log_entry != log_stats.end()) {
+    if (log_entry == log_stats.end()
+        || (snapshot_entry != snapshot.end() && snapshot_entry->pair_key < log_entry->pair_key)) {
+      stats.push_back(*snapshot_entry++);
+    } else if (snapshot_entry == snapshot.end() || log_entry->pair_key < snapshot_entry->pair_key) {
+      stats.push_back(*log_entry++);
+    } else {
+      PairStats combined = *snapshot_entry++;
+      combined.attempt_count += log_entry->attempt_count;
+      combined.correct_count += log_entry->correct_count;
+      combined.total_time_to_link_ms += log_entry->total_time_to_link_ms;
+      stats.push_back(combined);
+      log_entry++;
+    }
+  }
+
+  return stats;
+
+}
+
+const PairStats *AttemptLog::FindStats(const std::vector<PairStats> &stats, uint64_t pair_key) {
+
+  auto entry = std::lower_bound(stats.begin(), stats.end(), pair_key, [](const PairStats &a, uint64_t key) {
+    return a.pair_key < key;
+  });
+
+  if (entry == stats.end() || entry->pair_key != pair_key) {
+    return nullptr;
+  }
+  return &*entry;
+
+}
+
+uint64_t AttemptLog::GetPairKey(const char *left_word, const char *right_word) {
+  // The terminating NUL of the left word separates the two, so ("ab", "c") and ("a", "bc") hash differently
+  uint64_t hash = Fnv1a64(left_word, strlen(left_word) + 1);
+  return Fnv1a64(right_word, strlen(right_word), hash);
+}
+
+std::vector<PairStats> AttemptLog::ReadSnapshot() {
+
+  std::vector<PairStats> stats;
+
+  FILE *file = fopen(snapshot_path_.c_str(), "rb");
+  if (file == nullptr) {
+    return stats;
+  }
+
+  struct stat snapshot_stat;
+  if (fstat(fileno(file), &snapshot_stat) != 0) {
+    fclose(file);
+    return stats;
+  }
+
+  char magic[kMagicLength];
+  uint64_t count = 0;
+  if (fread(magic, 1, kMagicLength, file) == kMagicLength
+      && memcmp(magic, kSnapshotMagic, kMagicLength) == 0
+      && fread(&count, sizeof(count), 1, file) == 1) {
+    // The count comes from disk, so it is never trusted beyond what the file can actually hold
+    uint64_t header_size = kMagicLength + sizeof(count);
+    uint64_t stored_count = ((uint64_t) snapshot_stat.st_size - header_size) / sizeof(PairStats);
+    count = std::min(count, stored_count);
+    stats.resize(count);
+    stats.resize(fread(stats.data(), sizeof(PairStats), count, file));
+  } else {
+    printf("Warning: ignoring unrecognised attempt snapshot %s\n", snapshot_path_.c_str());
+  }
+
+  fclose(file);
+  return stats;
+
+}
+
+std::vector<AttemptRecord> AttemptLog::ReadLog() {
+
+  std::vector<AttemptRecord> records;
+
+  FILE *file = fopen(log_path_.c_str(), "rb");
+  if (file == nullptr) {
+    return records;
+  }
+
+  char magic[kMagicLength];
+  if (fread(magic, 1, kMagicLength, file) == kMagicLength && memcmp(magic, kLogMagic, kMagicLength) == 0) {
+    // A torn trailing record from an interrupted write is dropped by reading whole records only
+    records.resize(log_record_count_);
+    records.resize(fread(records.data(), sizeof(AttemptRecord), records.size(), file));
+  } else {
+    printf("Warning: ignoring unrecognised attempt log %s\n", log_path_.c_str());
+  }
+
+  fclose(file);
+  return records;
+
+}
+
+bool AttemptLog::WriteSnapshot(const std::vector<PairStats> &stats) {
+
+  // Write next to the old snapshot and rename over it, so an interrupted compaction leaves the old one intact
+  std::string temporary_path = snapshot_path_ + ".tmp";
+  FILE *file = fopen(temporary_path.c_str(), "wb");
+  if (file == nullptr) {
+    printf("Warning: unable to write attempt snapshot %s\n", temporary_path.c_str());
+    return false;
+  }
+
+  uint64_t count = stats.size();
+  bool written = fwrite(kSnapshotMagic, 1, kMagicLength, file) == kMagicLength
+      && fwrite(&count, sizeof(count), 1, file) == 1
+      && fwrite(stats.data(), sizeof(PairStats), stats.size(), file) == stats.size();
+  fclose(file);
+
+  if (!written || rename(temporary_path.c_str(), snapshot_path_.c_str()) != 0) {
+    printf("Warning: unable to replace attempt snapshot %s\n", snapshot_path_.c_str());
+    remove(temporary_path.c_str());
+    return false;
+  }
+
+  return true;
+
+}
+
+}
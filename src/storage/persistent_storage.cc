@@ -0,0 +1,59 @@
+#include <emscripten.h>
+#include "storage/persistent_storage.h"
+
+namespace cross_language_match {
+
+EM_ASYNC_JS(
+    void,
+    mount_idbfs,
+    (const char *directory_ptr),
+    {
+      var directory = UTF8ToString(directory_ptr);
+      FS.mkdir(directory);
+      FS.mount(IDBFS, {}, directory);
+      await new Promise(resolve => FS.syncfs(true, function(error) {
+        if (error) {
+          console.warn('Unable to load persistent storage', error);
+        }
+        resolve();
+      }));
+    }
+);
+
+EM_JS(
+    void,
+    sync_idbfs,
+    (),
+    {
+      // Only one sync may be in flight; requests made meanwhile are folded into a single follow-up sync
+      var sync = function() {
+        Module.idbfsSyncInFlight = true;
+        FS.syncfs(false, function(error) {
+          Module.idbfsSyncInFlight = false;
+          if (error) {
+            console.warn('Unable to save persistent storage', error);
+          }
+          if (Module.idbfsSyncPending) {
+            Module.idbfsSyncPending = false;
+            sync();
+          }
+        });
+      };
+
+      if (Module.idbfsSyncInFlight) {
+        Module.idbfsSyncPending = true;
+        return;
+      }
+      sync();
+    }
+);
+
+void MountPersistentStorage() {
+  mount_idbfs(kPersistentStorageDirectory);
+}
+
+void SyncPersistentStorage() {
+  sync_idbfs();
+}
+
+}
@@ -0,0 +1,166 @@
+#include <cstdio>
+#include <cstring>
+#include <sys/stat.h>
+#include "storage/binary_io.h"
+#include "storage/session_snapshot.h"
+
+namespace cross_language_match {
+
+static const char kStateMagic[] = "CLMSTAT1";
+static const char kRoundMagic[] = "CLMRND01";
+static const std::size_t kMagicLength = 8;
+
+SessionSnapshot::SessionSnapshot(std::string directory)
+    : deck_path_(directory + "/session.deck"),
+      state_path_(directory + "/session.state"),
+      round_path_(directory + "/session.round") {}
+
+bool SessionSnapshot::WriteDeck(Deck *deck) {
+  std::string temporary_path = deck_path_ + ".tmp";
+  return ReplaceFile(temporary_path, deck_path_, deck->WriteCompiled(temporary_path));
+}
+
+bool SessionSnapshot::WriteState(Deck *deck, LeitnerScheduler *scheduler) {
+
+  std::string temporary_path = state_path_ + ".tmp";
+  FILE *file = fopen(temporary_path.c_str(), "wb");
+  if (file == nullptr) {
+    return false;
+  }
+
+  bool written = fwrite(kStateMagic, 1, kMagicLength, file) == kMagicLength
+      && WriteValue(file, deck->GetContentHash())
+      && deck->WriteState(file)
+      && scheduler->WriteState(file);
+  fclose(file);
+
+  return ReplaceFile(temporary_path, state_path_, written);
+
+}
+
+bool SessionSnapshot::WriteRound(uint64_t deck_content_hash, const RoundSnapshot &round) {
+
+  std::string temporary_path = round_path_ + ".tmp";
+  FILE *file = fopen(temporary_path.c_str(), "wb");
+  if (file == nullptr) {
+    return false;
+  }
+
+  uint8_t results_recorded = round.results_recorded ? 1 : 0;
+  uint8_t round_complete = round.round_complete ? 1 : 0;
+  bool written = fwrite(kRoundMagic, 1, kMagicLength, file) == kMagicLength
+      && WriteValue(file, deck_content_hash)
+      && WriteValue(file, round.scheduler_round)
+      && WriteVector(file, round.pair_indices)
+      && WriteVector(file, round.right_order)
+      && WriteVector(file, round.links)
+      && WriteVector(file, round.error_counts)
+      && WriteValue(file, results_recorded)
+      && WriteValue(file, round_complete);
+  fclose(file);
+
+  return ReplaceFile(temporary_path, round_path_, written);
+
+}
+
+Deck *SessionSnapshot::ReadDeck(unsigned int seed) {
+
+  FILE *file = fopen(state_path_.c_str(), "rb");
+  if (file == nullptr) {
+    return nullptr;
+  }
+
+  uint64_t deck_content_hash = 0;
+  bool read = ReadStateHeader(file, &deck_content_hash);
+  fclose(file);
+
+  if (!read) {
+    return nullptr;
+  }
+  return Deck::ReadCompiled(deck_path_, deck_content_hash, seed);
+
+}
+
+bool SessionSnapshot::ReadState(Deck *deck, LeitnerScheduler *scheduler) {
+
+  FILE *file = fopen(state_path_.c_str(), "rb");
+  if (file == nullptr) {
+    return false;
+  }
+
+  uint64_t deck_content_hash = 0;
+  bool read = ReadStateHeader(file, &deck_content_hash)
+      && deck_content_hash == deck->GetContentHash()
+      && deck->ReadState(file)
+      && scheduler->ReadState(file);
+  fclose(file);
+
+  return read;
+
+}
+
+bool SessionSnapshot::ReadRound(uint64_t deck_content_hash, RoundSnapshot *round) {
+
+  FILE *file = fopen(round_path_.c_str(), "rb");
+  if (file == nullptr) {
+    return false;
+  }
+
+  // A round holds at most what fits on screen, so anything larger is corruption
+  const uint64_t max_round_size = 1 << 16;
+  char magic[kMagicLength];
+  uint64_t saved_deck_content_hash = 0;
+  uint8_t results_recorded = 0;
+  uint8_t round_complete = 0;
+  bool read = fread(magic, 1, kMagicLength, file) == kMagicLength
+      && memcmp(magic, kRoundMagic, kMagicLength) == 0
+      && ReadValue(file, &saved_deck_content_hash)
+      && saved_deck_content_hash == deck_content_hash
+      && ReadValue(file, &round->scheduler_round)
+      && ReadVector(file, &round->pair_indices, max_round_size)
+      && ReadVector(file, &round->right_order, max_round_size)
+      && ReadVector(file, &round->links, max_round_size)
+      && ReadVector(file, &round->error_counts, max_round_size)
+      && ReadValue(file, &results_recorded)
+      && ReadValue(file, &round_complete);
+  fclose(file);
+
+  round->results_recorded = results_recorded != 0;
+  round->round_complete = round_complete != 0;
+  return read;
+
+}
+
+bool SessionSnapshot::Exists() {
+  struct stat file_stat;
+  return stat(deck_path_.c_str(), &file_stat) == 0
+      && stat(state_path_.c_str(), &file_stat) == 0
+      && stat(round_path_.c_str(), &file_stat) == 0;
+}
+
+void SessionSnapshot::Clear() {
+  remove(round_path_.c_str());
+  remove(state_path_.c_str());
+  remove(deck_path_.c_str());
+}
+
+bool SessionSnapshot::ReadStateHeader(FILE *file, uint64_t *deck_content_hash) {
+  char magic[kMagicLength];
+  return fread(magic, 1, kMagicLength, file) == kMagicLength
+      && memcmp(magic, kStateMagic, kMagicLength) == 0
+      && ReadValue(file, deck_content_hash);
+}
+
+bool SessionSnapshot::ReplaceFile(const std::string &temporary_path, const std::string &path, bool written) {
+
+  if (!written || rename(temporary_path.c_str(), path.c_str()) != 0) {
+    printf("Warning: unable to write session snapshot %s\n", path.c_str());
+    remove(temporary_path.c_str());
+    return false;
+  }
+
+  return true;
+
+}
+
+}
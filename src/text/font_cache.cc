@@ -0,0 +1,267 @@
+#include <chrono>
+#include <stdexcept>
+#include <boost/format.hpp>
+#include "text/font_cache.h"
+#include "text/utf8.h"
+
+namespace cross_language_match {
+
+struct CodePointRange {
+  uint32_t first;
+  uint32_t last;
+};
+
+struct FontFace {
+  const char *asset;
+  std::vector<CodePointRange> ranges;
+  // ISO 15924 tag that SDL_ttf passes to HarfBuzz for shaping; the default font's scripts are left to be guessed
+  const char *script;
+  bool right_to_left;
+};
+
+// The first three faces are the default font: two subsets, whose ranges must match those made in CMakeLists.txt, and
+// the whole font. Each holds the characters of the one before it. The fallback fonts after them are only bundled if
+// they are in the assets directory.
+static const FontFace kFontFaces[] = {
+    {"fonts/OpenSans-Regular-ui.ttf", {{0x20, 0x7E}}, nullptr, false},
+    {"fonts/OpenSans-Regular-latin.ttf",
+     {{0x20, 0x7E}, {0xA0, 0x24F}, {0x2010, 0x2027}, {0x2030, 0x203A}, {0x20AC, 0x20AC}}, nullptr, false},
+    {"fonts/OpenSans-Regular.ttf",
+     {{0x20, 0x7E}, {0xA0, 0x52F}, {0x1E00, 0x1FFF}, {0x2000, 0x22FF}, {0x2500, 0x25FF}, {0xFB00, 0xFB06},
+      {0xFFFC, 0xFFFD}}, nullptr, false},
+    {"fonts/NotoSansHebrew-Regular.ttf", {{0x590, 0x5FF}, {0xFB1D, 0xFB4F}}, "Hebr", true},
+    {"fonts/NotoSansArabic-Regular.ttf",
+     {{0x600, 0x6FF}, {0x750, 0x77F}, {0x8A0, 0x8FF}, {0xFB50, 0xFDFF}, {0xFE70, 0xFEFF}}, "Arab", true},
+    {"fonts/NotoSansDevanagari-Regular.ttf", {{0x900, 0x97F}, {0xA8E0, 0xA8FF}}, "Deva", false},
+    {"fonts/NotoSansThai-Regular.ttf", {{0xE00, 0xE7F}}, "Thai", false},
+    {"fonts/NotoSansSC-Regular.ttf",
+     {{0x2E80, 0x2FDF}, {0x3000, 0x30FF}, {0x31F0, 0x31FF}, {0x3400, 0x4DBF}, {0x4E00, 0x9FFF}, {0xF900, 0xFAFF},
+      {0xFF00, 0xFFEF}}, "Hani", false},
+    {"fonts/NotoSansKR-Regular.ttf", {{0x1100, 0x11FF}, {0x3130, 0x318F}, {0xAC00, 0xD7AF}}, "Hang", false},
+};
+static const int kFaceCount = sizeof(kFontFaces) / sizeof(kFontFaces[0]);
+static const int kFullFontFace = 2;
+static const int kFirstFallbackFace = 3;
+
+// The game's own strings are drawn from 22 to 44 pt; the distance field scales up that far without rounding corners
+static const int kUiAtlasPointSize = 32;
+
+// Whether a glyph is provided does not depend on the size, so the check opens the smallest size in use anywhere
+static const int kCoverageCheckPointSize = 22;
+
+FontCache::FontCache(AssetBundle *asset_bundle)
+    : asset_bundle_(asset_bundle),
+      missing_faces_(kFaceCount, false),
+      fetched_faces_(kFaceCount, false),
+      noted_code_points_(kMaxCodePoint + 1, false),
+      shaped_text_cache_(new ShapedTextCache()) {
+
+  if (TTF_Init() == -1) {
+    throw std::runtime_error(
+        boost::str(boost::format("SDL_ttf could not be initialized, error: %1%\n") % TTF_GetError())
+    );
+  }
+
+}
+
+FontCache::~FontCache() {
+
+  delete shaped_text_cache_;
+  shaped_text_cache_ = nullptr;
+
+  for (auto &ui_font : ui_fonts_) {
+    delete ui_font.second;
+  }
+  ui_fonts_.clear();
+
+  delete ui_atlas_;
+  ui_atlas_ = nullptr;
+
+  for (auto &font_chain : word_font_chains_) {
+    delete font_chain.second;
+  }
+  word_font_chains_.clear();
+
+  for (auto &font : fonts_) {
+    TTF_CloseFont(font.second);
+  }
+  fonts_.clear();
+
+  TTF_Quit();
+
+}
+
+SdfFont *FontCache::GetFont(int point_size) {
+
+  auto found = ui_fonts_.find(point_size);
+  if (found != ui_fonts_.end()) {
+    return found->second;
+  }
+
+  if (ui_atlas_ == nullptr) {
+    TTF_Font *font = OpenFace(0, kUiAtlasPointSize);
+    auto start_time = std::chrono::steady_clock::now();
+    ui_atlas_ = new SdfAtlas(font, kUiAtlasPointSize);
+    printf("Built the distance field atlas of %s in %.1f ms (%d KB)\n",
+           kFontFaces[0].asset,
+           std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count(),
+           (int) (ui_atlas_->GetSizeBytes() / 1024));
+  }
+
+  SdfFont *font = new SdfFont(ui_atlas_, point_size);
+  ui_fonts_[point_size] = font;
+  return font;
+
+}
+
+FontChain *FontCache::GetWordFontChain(int point_size) {
+  return GetFontChain(first_word_face_, point_size);
+}
+
+FontChain *FontCache::GetFontChain(int first_face, int point_size) {
+
+  auto found = word_font_chains_.find({first_face, point_size});
+  if (found != word_font_chains_.end()) {
+    return found->second;
+  }
+
+  std::vector<int> faces;
+  for (int face = first_face; face < kFaceCount; face++) {
+    faces.push_back(face);
+  }
+  FontChain *font_chain = new FontChain(this, faces, point_size);
+  word_font_chains_[{first_face, point_size}] = font_chain;
+  return font_chain;
+
+}
+
+ShapedTextCache *FontCache::GetShapedTextCache() {
+  return shaped_text_cache_;
+}
+
+void FontCache::CoverDeck(Deck *deck) {
+
+  noted_code_points_.assign(noted_code_points_.size(), false);
+  first_word_face_ = 0;
+  if (deck->IsPaged()) {
+    return;
+  }
+
+  auto start_time = std::chrono::steady_clock::now();
+  for (int pair_index = 0; pair_index < deck->GetPairCount(); pair_index++) {
+    CoverWord(deck->GetLeftWord(pair_index));
+    CoverWord(deck->GetRightWord(pair_index));
+  }
+
+  printf("Noted the characters of %d pairs in %.1f ms; their words are drawn from %s first\n",
+         deck->GetPairCount(),
+         std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count(),
+         kFontFaces[first_word_face_].asset);
+
+}
+
+void FontCache::CoverWord(const char *word) {
+
+  while (*word != '\0') {
+
+    // The smallest subset holds all of printable ASCII, which is most characters of most decks
+    uint32_t code_point = DecodeUtf8(&word);
+    if (code_point < 0x80 || noted_code_points_[code_point]) {
+      continue;
+    }
+
+    // Characters of other scripts come from fallback fonts, and leave the default font's subset as it is
+    noted_code_points_[code_point] = true;
+    while (first_word_face_ < kFullFontFace && !IsInFace(first_word_face_, code_point)
+        && IsInFace(kFullFontFace, code_point)) {
+      first_word_face_++;
+    }
+
+  }
+
+}
+
+std::vector<uint32_t> FontCache::FindUnrenderableCodePoints() {
+
+  std::vector<uint32_t> unrenderable;
+  FontChain *font_chain = GetWordFontChain(kCoverageCheckPointSize);
+  for (uint32_t code_point = 0x80; code_point <= kMaxCodePoint; code_point++) {
+    if (noted_code_points_[code_point] && !TTF_GlyphIsProvided32(font_chain->FindFont(code_point), code_point)) {
+      unrenderable.push_back(code_point);
+    }
+  }
+
+  return unrenderable;
+
+}
+
+bool FontCache::IsInFace(int face, uint32_t code_point) {
+
+  for (const CodePointRange &range : kFontFaces[face].ranges) {
+    if (code_point >= range.first && code_point <= range.last) {
+      return true;
+    }
+  }
+  return false;
+
+}
+
+bool FontCache::IsRightToLeftFace(int face) {
+  return kFontFaces[face].right_to_left;
+}
+
+TTF_Font *FontCache::OpenFace(int face, int point_size) {
+
+  auto found = fonts_.find({face, point_size});
+  if (found != fonts_.end()) {
+    return found->second;
+  }
+  if (missing_faces_[face]) {
+    return nullptr;
+  }
+
+  // A deck in a script without a bundled font can still be played; only the default font is required
+  const std::vector<char> *font_file = nullptr;
+  try {
+    font_file = &asset_bundle_->GetAsset(kFontFaces[face].asset);
+  } catch (const std::runtime_error &) {
+    if (face < kFirstFallbackFace) {
+      throw;
+    }
+    printf("Fallback font %s is not in the bundle; its characters are drawn as placeholders\n",
+           kFontFaces[face].asset);
+    missing_faces_[face] = true;
+    return nullptr;
+  }
+  if (!fetched_faces_[face]) {
+    fetched_faces_[face] = true;
+    font_file_bytes_ += font_file->size();
+  }
+
+  // The bundle keeps the bytes for as long as the cache, so the font reads them in place
+  auto start_time = std::chrono::steady_clock::now();
+  TTF_Font *font = TTF_OpenFontRW(SDL_RWFromConstMem(font_file->data(), (int) font_file->size()), 1, point_size);
+  if (font == nullptr) {
+    throw std::runtime_error(boost::str(boost::format("Failed to load font, error: %1%\n") % TTF_GetError()));
+  }
+
+  // Without HarfBuzz in SDL_ttf the words are still drawn, one glyph after another, which is wrong for these scripts
+  if (kFontFaces[face].script != nullptr) {
+    if (TTF_SetFontScriptName(font, kFontFaces[face].script) != 0
+        || TTF_SetFontDirection(font, kFontFaces[face].right_to_left ? TTF_DIRECTION_RTL : TTF_DIRECTION_LTR) != 0) {
+      printf("Warning: unable to shape %s text, error: %s\n", kFontFaces[face].script, TTF_GetError());
+    }
+  }
+
+  printf("Opened font %s at %d pt in %.2f ms (%d KB of font files resident)\n",
+         kFontFaces[face].asset,
+         point_size,
+         std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count(),
+         (int) (font_file_bytes_ / 1024));
+
+  fonts_[{face, point_size}] = font;
+  return font;
+
+}
+
+}
@@ -0,0 +1,92 @@
+#include <cctype>
+#include <cmath>
+#include "text/font_chain.h"
+#include "text/font_cache.h"
+#include "text/utf8.h"
+
+namespace cross_language_match {
+
+static bool IsCombiningMark(uint32_t code_point) {
+  return (code_point >= 0x300 && code_point <= 0x36F)
+      || (code_point >= 0x1AB0 && code_point <= 0x1AFF)
+      || (code_point >= 0x20D0 && code_point <= 0x20FF)
+      || (code_point >= 0xFE20 && code_point <= 0xFE2F);
+}
+
+// Spaces and ASCII punctuation, which take the direction of the text around them
+static bool IsNeutral(uint32_t code_point) {
+  return code_point < 0x80 && !isalnum((int) code_point);
+}
+
+FontChain::FontChain(FontCache *font_cache, std::vector<int> faces, int point_size)
+    : font_cache_(font_cache),
+      faces_(faces),
+      point_size_(point_size) {}
+
+void FontChain::Segment(const std::string &text, std::vector<FontRun> *runs) {
+
+  runs->clear();
+  const char *start = text.c_str();
+  const char *next = start;
+  while (*next != '\0') {
+
+    std::size_t begin = next - start;
+    uint32_t code_point = DecodeUtf8(&next);
+
+    // Right-to-left fonts have their own spaces and punctuation, which keeps a phrase in one run shaped as a whole
+    if (!runs->empty() && (IsCombiningMark(code_point)
+        || (runs->back().right_to_left && IsNeutral(code_point)
+            && TTF_GlyphIsProvided32(runs->back().font, code_point)))) {
+      runs->back().end = next - start;
+      continue;
+    }
+
+    // Printable ASCII is in every face's first subset, which is the common case worth skipping the search for
+    int face = code_point < 0x80 ? faces_.front() : FindFace(code_point);
+    TTF_Font *font = font_cache_->OpenFace(face, point_size_);
+    if (!runs->empty() && runs->back().font == font) {
+      runs->back().end = next - start;
+    } else {
+      runs->push_back({font, begin, (std::size_t) (next - start), font_cache_->IsRightToLeftFace(face)});
+    }
+
+  }
+
+}
+
+TTF_Font *FontChain::FindFont(uint32_t code_point) {
+  return font_cache_->OpenFace(FindFace(code_point), point_size_);
+}
+
+int FontChain::FindFace(uint32_t code_point) {
+
+  for (int face : faces_) {
+    if (font_cache_->IsInFace(face, code_point) && font_cache_->OpenFace(face, point_size_) != nullptr) {
+      return face;
+    }
+  }
+
+  // The first face draws its placeholder glyph
+  return faces_.front();
+
+}
+
+TTF_Font *FontChain::GetPrimaryFont() {
+  return font_cache_->OpenFace(faces_.front(), point_size_);
+}
+
+ShapedTextCache *FontChain::GetShapedTextCache() {
+  return font_cache_->GetShapedTextCache();
+}
+
+FontChain *FontChain::AtPixelScale(float pixel_scale) {
+
+  int point_size = (int) std::lround(point_size_ * pixel_scale);
+  if (point_size == point_size_) {
+    return this;
+  }
+  return font_cache_->GetFontChain(faces_.front(), point_size);
+
+}
+
+}
@@ -5,29 +5,42 @@
 
 namespace cross_language_match {
 
-InteractiveText::InteractiveText(SDL_Renderer *renderer, Text *text, InteractiveTextGroup group)
+InteractiveText::InteractiveText(SDL_Renderer *renderer, Text *text, MatchBoard *board, int slot)
     : Rectangle(renderer,
                 text->GetWidth() + text_padding_per_side_ * 2,
                 text->GetHeight() + text_padding_per_side_ * 2),
       renderer_(renderer),
       text_(text),
-      linked_interactive_text_(nullptr),
-      is_highlighted_(false),
-      group_(group),
+      board_(board),
+      slot_(slot),
       interactive_line_color_({0x48, 0x3C, 0x32, 0xFF}),
       interactive_text_highlight_color_({0x4E, 0xC3, 0x3D, 0xFF}),
       interactive_text_non_highlight_color_({0x48, 0x3C, 0x32, 0xFF}),
       interactive_text_non_highlight_mouse_over_color_({0x1A, 0x56, 0x53, 0xFF}),
-      link_cancellation_circle_(nullptr),
+      link_cancellation_circle_(renderer),
+      line_one_x1_(0), line_one_x2_(0), line_one_y1_(0), line_one_y2_(0),
+      line_two_x1_(0), line_two_x2_(0), line_two_y1_(0), line_two_y2_(0) {}
+
+InteractiveText::InteractiveText(SDL_Renderer *renderer, int height, MatchBoard *board, int slot)
+    : Rectangle(renderer, 0, height),
+      renderer_(renderer),
+      text_(nullptr),
+      board_(board),
+      slot_(slot),
+      interactive_line_color_({0x48, 0x3C, 0x32, 0xFF}),
+      interactive_text_highlight_color_({0x4E, 0xC3, 0x3D, 0xFF}),
+      interactive_text_non_highlight_color_({0x48, 0x3C, 0x32, 0xFF}),
+      interactive_text_non_highlight_mouse_over_color_({0x1A, 0x56, 0x53, 0xFF}),
+      link_cancellation_circle_(renderer),
       line_one_x1_(0), line_one_x2_(0), line_one_y1_(0), line_one_y2_(0),
       line_two_x1_(0), line_two_x2_(0), line_two_y1_(0), line_two_y2_(0) {}
 
 void InteractiveText::AddHighlight() {
-  is_highlighted_ = true;
+  board_->AddHighlight(slot_);
 }
 
 void InteractiveText::RemoveHighlight() {
-  is_highlighted_ = false;
+  board_->RemoveHighlight(slot_);
 }
 
 void InteractiveText::AddLink(InteractiveText *other) {
@@ -36,24 +49,26 @@ void InteractiveText::AddLink(InteractiveText *other) {
     return;
   }
 
-  if (linked_interactive_text_ != nullptr) {
+  if (IsLinked() || other->IsLinked()) {
     return;
   }
 
-  linked_interactive_text_ = other;
+  board_->Link(slot_, other->slot_);
 
-  // The line should be drawn from the middle of the right edge of the *left* word to the middle of the left edge
-  // of the right word
-  InteractiveText *left_interactive_text;
-  InteractiveText *right_interactive_text;
-  if (group_ == LEFT) {
-    left_interactive_text = this;
-    right_interactive_text = linked_interactive_text_;
+  if (GetGroup() == LEFT) {
+    BuildLinkGeometry(other);
   } else {
-    left_interactive_text = linked_interactive_text_;
-    right_interactive_text = this;
+    other->BuildLinkGeometry(this);
   }
 
+}
+
+void InteractiveText::BuildLinkGeometry(InteractiveText *right_interactive_text) {
+
+  // The line should be drawn from the middle of the right edge of the *left* word to the middle of the left edge
+  // of the right word
+  InteractiveText *left_interactive_text = this;
+
   // We calculate the slope of the line from the left interactive text object to the right interactive text object
   double y_delta = (right_interactive_text->GetTopLeftY() + (double) right_interactive_text->GetHeight() / 2)
       - (left_interactive_text->GetTopLeftY() + (double) left_interactive_text->GetHeight() / 2);
@@ -96,35 +111,36 @@ void InteractiveText::AddLink(InteractiveText *other) {
   line_two_x2_ = right_interactive_text->GetTopLeftX();
   line_two_y2_ = right_interactive_text->GetTopLeftY() + right_interactive_text->GetHeight() / 2;
 
-  link_cancellation_circle_ = new CancellationCircleButton(renderer_);
-  link_cancellation_circle_->SetRadius(circle_radius);
-  link_cancellation_circle_->SetCenter(offset_x + circle_center_x, offset_y + circle_center_y);
-  link_cancellation_circle_->SetColor({interactive_line_color_.r,
+  link_cancellation_circle_.SetRadius(circle_radius);
+  link_cancellation_circle_.SetCenter(offset_x + circle_center_x, offset_y + circle_center_y);
+  link_cancellation_circle_.SetColor({interactive_line_color_.r,
                                        interactive_line_color_.g,
                                        interactive_line_color_.b,
                                        interactive_line_color_.a});
 }
 
-void InteractiveText::RemoveLink() {
+void InteractiveText::RebuildLinkGeometry(const std::vector<InteractiveText *> &all_words) {
 
-  if (linked_interactive_text_ == nullptr) {
-    return;
+  if (IsLinked() && GetGroup() == LEFT) {
+    BuildLinkGeometry(all_words[board_->GetLink(slot_)]);
   }
 
-  linked_interactive_text_ = nullptr;
+}
 
-  delete link_cancellation_circle_;
-  link_cancellation_circle_ = nullptr;
+void InteractiveText::RemoveLink() {
+
+  // The cancellation circle is simply not rendered or hit-tested while the board reports no link
+  board_->Unlink(slot_);
 
 }
 
-InteractiveText *InteractiveText::GetLink() {
-  return linked_interactive_text_;
+bool InteractiveText::IsLinked() {
+  return board_->IsLinked(slot_);
 }
 
-void InteractiveText::Render() {
+void InteractiveText::RenderLink() {
 
-  if (GetLink() != nullptr) {
+  if (IsLinked() && GetGroup() == LEFT) {
 
     SDL_SetRenderDrawColor(renderer_,
                            interactive_line_color_.r,
@@ -132,11 +148,30 @@ void InteractiveText::Render() {
                            interactive_line_color_.b,
                            interactive_line_color_.a);
     SDL_RenderDrawLine(renderer_, line_one_x1_, line_one_y1_, line_one_x2_, line_one_y2_);
-    link_cancellation_circle_->Render();
+    link_cancellation_circle_.Render();
     SDL_RenderDrawLine(renderer_, line_two_x1_, line_two_y1_, line_two_x2_, line_two_y2_);
   }
 
-  if (is_highlighted_) {
+}
+
+void InteractiveText::RenderDragLine(int to_x, int to_y) {
+
+  int from_x = GetGroup() == LEFT ? GetTopLeftX() + GetWidth() : GetTopLeftX();
+  int from_y = GetTopLeftY() + GetHeight() / 2;
+  SDL_SetRenderDrawColor(renderer_,
+                         interactive_line_color_.r,
+                         interactive_line_color_.g,
+                         interactive_line_color_.b,
+                         interactive_line_color_.a);
+  SDL_RenderDrawLine(renderer_, from_x, from_y, to_x, to_y);
+
+}
+
+void InteractiveText::Render() {
+
+  RenderLink();
+
+  if (board_->IsHighlighted(slot_)) {
 
     Rectangle::SetColor({
                             interactive_text_highlight_color_.r,
@@ -145,7 +180,7 @@ void InteractiveText::Render() {
                             interactive_text_highlight_color_.a
                         });
 
-  } else if (IsMouseInside() && GetLink() == nullptr) {
+  } else if (IsMouseInside() && !IsLinked()) {
 
     Rectangle::SetColor({
                             interactive_text_non_highlight_mouse_over_color_.r,
@@ -172,20 +207,18 @@ void InteractiveText::Render() {
 void InteractiveText::SetTopLeftPosition(int top_left_x, int top_left_y) {
 
   Rectangle::SetTopLeftPosition(top_left_x, top_left_y);
-  text_->SetTopLeftPosition(GetTopLeftX() + text_padding_per_side_,
-                            GetTopLeftY() + text_padding_per_side_);
+  if (text_ != nullptr) {
+    text_->SetTopLeftPosition(GetTopLeftX() + text_padding_per_side_,
+                              GetTopLeftY() + text_padding_per_side_);
+  }
 
 }
 
-void InteractiveText::HandleEvent(SDL_Event *event, std::vector<InteractiveText *> all_words) {
+void InteractiveText::HandleEvent(SDL_Event *event, const std::vector<InteractiveText *> &all_words) {
 
-  if (link_cancellation_circle_ != nullptr && link_cancellation_circle_->HandleEvent(event) == PRESSED) {
-
-    if (this->GetLink() != nullptr) {
-      this->GetLink()->RemoveHighlight();
-      this->GetLink()->RemoveLink();
-    }
+  if (IsLinked() && GetGroup() == LEFT && link_cancellation_circle_.HandleEvent(event) == PRESSED) {
 
+    all_words[board_->GetLink(slot_)]->RemoveHighlight();
     this->RemoveHighlight();
     this->RemoveLink();
 
@@ -193,31 +226,27 @@ void InteractiveText::HandleEvent(SDL_Event *event, std::vector<InteractiveText
 
   if (IsMouseInside() && event->type == SDL_MOUSEBUTTONDOWN && event->button.button == SDL_BUTTON_LEFT) {
 
-    if (GetLink() != nullptr) {
+    if (IsLinked()) {
 
       // Do nothing if already linked
 
-    } else if (is_highlighted_) {
+    } else if (board_->IsHighlighted(slot_)) {
 
       RemoveHighlight();
 
     } else { // Not linked and not highlighted
 
+      // Highlighting replaces any existing highlight from this word's own group
       this->AddHighlight();
 
-      // Find if any of the already existing words from a different group are already highlighted; if so, link them and remove highlighting.
-      InteractiveText *existing_highlighted_from_other_group = GetHighlightedOtherFromDifferentGroup(all_words);
-      if (existing_highlighted_from_other_group != nullptr) {
+      // If a word from the other group is already highlighted, link the two of them and remove highlighting
+      InteractiveTextGroup other_group = GetGroup() == LEFT ? RIGHT : LEFT;
+      int highlighted_slot_from_other_group = board_->GetHighlightedSlot(other_group);
+      if (highlighted_slot_from_other_group != MatchBoard::kNoSlot) {
+        InteractiveText *existing_highlighted_from_other_group = all_words[highlighted_slot_from_other_group];
         this->RemoveHighlight();
         existing_highlighted_from_other_group->RemoveHighlight();
         this->AddLink(existing_highlighted_from_other_group);
-        existing_highlighted_from_other_group->AddLink(this);
-      }
-
-      // ELSE, find if any already existing words from this group are already highlighted; if so, remove that other object's highlighting.
-      InteractiveText *existing_highlighted_from_same_group = GetHighlightedOtherFromSameGroup(all_words);
-      if (existing_highlighted_from_same_group != nullptr) {
-        existing_highlighted_from_same_group->RemoveHighlight();
       }
     }
   }
@@ -227,54 +256,34 @@ const Text *InteractiveText::GetText() {
   return text_;
 }
 
-InteractiveTextGroup InteractiveText::GetGroup() {
-  return group_;
+void InteractiveText::SetText(Text *text) {
+  text_ = text;
+  SetWidth(text_->GetWidth() + text_padding_per_side_ * 2);
+  SetHeight(text_->GetHeight() + text_padding_per_side_ * 2);
+  SetTopLeftPosition(GetTopLeftX(), GetTopLeftY());
 }
 
-InteractiveText *InteractiveText::GetHighlightedOtherFromSameGroup(std::vector<InteractiveText *> all_text) {
-
-  for (auto &single_text : all_text) {
-
-    if (single_text == this) {
-      continue;
-    }
-
-    if (single_text->is_highlighted_ && single_text->group_ == this->group_) {
-      printf("Current object (%s); found other text from same group (%s) which is highlighted)\n",
-             this->GetText()->GetString().c_str(),
-             single_text->GetText()->GetString().c_str());
-      return single_text;
-    }
-
-  }
-
-  return nullptr;
-
+Text *InteractiveText::ReleaseText() {
+  Text *text = text_;
+  text_ = nullptr;
+  SetWidth(0);
+  return text;
 }
 
-InteractiveText *InteractiveText::GetHighlightedOtherFromDifferentGroup(std::vector<InteractiveText *> all_text) {
-
-  for (InteractiveText *single_text : all_text) {
-
-    if (single_text == this) {
-      continue;
-    }
-
-    if (single_text->is_highlighted_ && single_text->group_ != this->group_) {
-      printf("Current object (%s); found other text from different group (%s) which is highlighted)\n",
-             this->GetText()->GetString().c_str(),
-             single_text->GetText()->GetString().c_str());
-      return single_text;
-    }
-
-  }
+bool InteractiveText::HasText() {
+  return text_ != nullptr;
+}
 
-  return nullptr;
+InteractiveTextGroup InteractiveText::GetGroup() {
+  return board_->GetColumn(slot_);
+}
 
+int InteractiveText::GetSlot() {
+  return slot_;
 }
 
 int InteractiveText::GetPaddingPerSide() {
   return text_padding_per_side_;
 }
 
-}
\ No newline at end of file
+}
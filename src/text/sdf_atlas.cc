@@ -0,0 +1,307 @@
+#include <algorithm>
+#include <cmath>
+#include "text/sdf_atlas.h"
+#include "text/utf8.h"
+
+namespace cross_language_match {
+
+static const uint32_t kFirstCharacter = 0x20;
+static const uint32_t kLastCharacter = 0x7E;
+static const int kAtlasWidth = 512;
+// How far, in reference pixels, the field reaches on either side of an edge. It must cover the widest edge drawn, which
+// is half a pixel at the smallest size.
+static const int kSpread = 4;
+static const float kFar = 1e20f;
+
+// One pass of the Felzenszwalb and Huttenlocher distance transform, over a row or a column of squared distances
+static void TransformLine(float *grid, int offset, int stride, int length, float *f, int *v, float *z) {
+
+  v[0] = 0;
+  z[0] = -kFar;
+  z[1] = kFar;
+  f[0] = grid[offset];
+
+  for (int q = 1, k = 0; q < length; q++) {
+    f[q] = grid[offset + q * stride];
+    float s;
+    do {
+      int r = v[k];
+      s = (f[q] - f[r] + (float) (q * q - r * r)) / (float) (q - r) / 2;
+    } while (s <= z[k] && --k > -1);
+    k++;
+    v[k] = q;
+    z[k] = s;
+    z[k + 1] = kFar;
+  }
+
+  for (int q = 0, k = 0; q < length; q++) {
+    while (z[k + 1] < q) {
+      k++;
+    }
+    int r = v[k];
+    grid[offset + q * stride] = f[r] + (float) ((q - r) * (q - r));
+  }
+
+}
+
+static void Transform(std::vector<float> *grid, int width, int height) {
+
+  int length = std::max(width, height);
+  std::vector<float> f(length);
+  std::vector<int> v(length);
+  std::vector<float> z(length + 1);
+
+  for (int x = 0; x < width; x++) {
+    TransformLine(grid->data(), x, width, height, f.data(), v.data(), z.data());
+  }
+  for (int y = 0; y < height; y++) {
+    TransformLine(grid->data(), y * width, 1, width, f.data(), v.data(), z.data());
+  }
+
+}
+
+SdfAtlas::SdfAtlas(TTF_Font *font, int reference_point_size)
+    : reference_point_size_(reference_point_size),
+      font_height_(TTF_FontHeight(font)),
+      line_skip_(TTF_FontLineSkip(font)),
+      atlas_width_(kAtlasWidth),
+      atlas_height_(0) {
+
+  // Every cell is one line high, so the cells are packed in rows
+  int atlas_x = atlas_width_;
+  int atlas_y = -(font_height_ + 2 * kSpread);
+  for (uint32_t code_point = kFirstCharacter; code_point <= kLastCharacter; code_point++) {
+    AddGlyph(font, code_point, &atlas_x, &atlas_y);
+  }
+
+  // The font's own placeholder, which the smallest subset draws for the replacement character
+  AddGlyph(font, kReplacementCharacter, &atlas_x, &atlas_y);
+
+}
+
+void SdfAtlas::AddGlyph(TTF_Font *font, uint32_t code_point, int *atlas_x, int *atlas_y) {
+
+  int min_x = 0;
+  int advance = 0;
+  TTF_GlyphMetrics32(font, code_point, &min_x, nullptr, nullptr, nullptr, &advance);
+
+  // Rendered as SDL_ttf renders a one character string: a line high, with the pen at the left edge unless the glyph
+  // reaches behind it. A glyph with nothing to draw, such as a space, fails to render and gets an empty cell.
+  SDL_Surface *glyph_surface = TTF_RenderGlyph32_Blended(font, code_point, {0xFF, 0xFF, 0xFF, 0xFF});
+  SDL_Surface *coverage_surface = nullptr;
+  if (glyph_surface != nullptr) {
+    coverage_surface = SDL_ConvertSurfaceFormat(glyph_surface, SDL_PIXELFORMAT_ARGB8888, 0);
+    SDL_FreeSurface(glyph_surface);
+  }
+  int glyph_width = coverage_surface == nullptr ? 0 : coverage_surface->w;
+  int glyph_height = coverage_surface == nullptr ? 0 : std::min(coverage_surface->h, font_height_);
+
+  Glyph glyph = {0, 0, glyph_width + 2 * kSpread, font_height_ + 2 * kSpread, std::min(min_x, 0) - kSpread, advance};
+  if (*atlas_x + glyph.width > atlas_width_) {
+    *atlas_x = 0;
+    *atlas_y += glyph.height;
+    atlas_height_ += glyph.height;
+    atlas_.resize((std::size_t) atlas_width_ * atlas_height_, 0);
+  }
+  glyph.atlas_x = *atlas_x;
+  glyph.atlas_y = *atlas_y;
+  *atlas_x += glyph.width;
+
+  // Squared distances to the nearest pixel outside the glyph and to the nearest inside it. Partly covered pixels are
+  // seeded with how far the edge is from their centre, which keeps the anti-aliasing in the field.
+  std::vector<float> outer((std::size_t) glyph.width * glyph.height, kFar);
+  std::vector<float> inner((std::size_t) glyph.width * glyph.height, 0);
+  for (int y = 0; y < glyph_height; y++) {
+    const Uint32 *row = (const Uint32 *) ((const Uint8 *) coverage_surface->pixels + y * coverage_surface->pitch);
+    for (int x = 0; x < glyph_width; x++) {
+      float coverage = (float) (row[x] >> 24) / 255;
+      if (coverage == 0) {
+        continue;
+      }
+      std::size_t i = (std::size_t) (y + kSpread) * glyph.width + x + kSpread;
+      if (coverage == 1) {
+        outer[i] = 0;
+        inner[i] = kFar;
+      } else {
+        float edge_distance = 0.5f - coverage;
+        outer[i] = edge_distance > 0 ? edge_distance * edge_distance : 0;
+        inner[i] = edge_distance < 0 ? edge_distance * edge_distance : 0;
+      }
+    }
+  }
+  SDL_FreeSurface(coverage_surface);
+
+  Transform(&outer, glyph.width, glyph.height);
+  Transform(&inner, glyph.width, glyph.height);
+
+  // Stored inside positive, with the edge at the middle of the byte range
+  for (int y = 0; y < glyph.height; y++) {
+    for (int x = 0; x < glyph.width; x++) {
+      std::size_t i = (std::size_t) y * glyph.width + x;
+      float distance = std::sqrt(inner[i]) - std::sqrt(outer[i]);
+      float value = std::round(128 + distance * 127 / kSpread);
+      atlas_[(std::size_t) (glyph.atlas_y + y) * atlas_width_ + glyph.atlas_x + x] =
+          (uint8_t) std::min(std::max(value, 0.0f), 255.0f);
+    }
+  }
+
+  glyphs_.push_back(glyph);
+
+}
+
+SDL_Surface *SdfAtlas::Render(const std::string &text, float point_size, SDL_Color color, int wrap_length_pixels) {
+
+  float scale = point_size / (float) reference_point_size_;
+  std::vector<PlacedGlyph> placed_glyphs;
+  int line_count = LayOut(text, scale, wrap_length_pixels, &placed_glyphs);
+
+  int extent = 0;
+  for (const PlacedGlyph &placed_glyph : placed_glyphs) {
+    extent = std::max(extent, placed_glyph.pen_x + placed_glyph.glyph->advance);
+  }
+  int width = (int) std::ceil(extent * scale);
+  int height = (int) std::ceil((font_height_ + (line_count - 1) * line_skip_) * scale);
+  if (width == 0 || height == 0) {
+    SDL_SetError("Text has zero width");
+    return nullptr;
+  }
+
+  SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+  if (surface == nullptr) {
+    return nullptr;
+  }
+
+  // Fully transparent pixels still carry the color, so that scaling the texture does not darken the edges
+  Uint32 clear_pixel = ((Uint32) color.r << 16) | ((Uint32) color.g << 8) | color.b;
+  for (int y = 0; y < height; y++) {
+    Uint32 *row = (Uint32 *) ((Uint8 *) surface->pixels + y * surface->pitch);
+    std::fill(row, row + width, clear_pixel);
+  }
+
+  for (const PlacedGlyph &placed_glyph : placed_glyphs) {
+    DrawGlyph(placed_glyph, scale, surface, color.a);
+  }
+
+  return surface;
+
+}
+
+std::size_t SdfAtlas::GetSizeBytes() {
+  return atlas_.size();
+}
+
+const SdfAtlas::Glyph &SdfAtlas::FindGlyph(uint32_t code_point) {
+
+  if (code_point < kFirstCharacter || code_point > kLastCharacter) {
+    return glyphs_.back();
+  }
+  return glyphs_[code_point - kFirstCharacter];
+
+}
+
+int SdfAtlas::LayOut(const std::string &text,
+                     float scale,
+                     int wrap_length_pixels,
+                     std::vector<PlacedGlyph> *placed_glyphs) {
+
+  // Like SDL_ttf, lines break at newlines, and at the last space before the wrap length, which is dropped
+  float wrap_length = wrap_length_pixels > 0 ? (float) wrap_length_pixels / scale : kFar;
+  int line = 0;
+  int pen_x = 0;
+  std::size_t line_start = 0;
+  std::size_t last_space = 0;
+  bool line_has_space = false;
+
+  const char *next = text.c_str();
+  while (*next != '\0') {
+
+    uint32_t code_point = DecodeUtf8(&next);
+    if (code_point == '\n') {
+      line++;
+      pen_x = 0;
+      line_start = placed_glyphs->size();
+      line_has_space = false;
+      continue;
+    }
+
+    const Glyph &glyph = FindGlyph(code_point);
+    if (code_point == ' ' && placed_glyphs->size() > line_start) {
+      last_space = placed_glyphs->size();
+      line_has_space = true;
+    }
+    placed_glyphs->push_back({&glyph, pen_x, line});
+    pen_x += glyph.advance;
+
+    if (pen_x > wrap_length && line_has_space) {
+      line++;
+      pen_x = 0;
+      placed_glyphs->erase(placed_glyphs->begin() + last_space);
+      for (std::size_t i = last_space; i < placed_glyphs->size(); i++) {
+        (*placed_glyphs)[i].pen_x = pen_x;
+        (*placed_glyphs)[i].line = line;
+        pen_x += (*placed_glyphs)[i].glyph->advance;
+      }
+      line_start = last_space;
+      line_has_space = false;
+    }
+
+  }
+
+  return line + 1;
+
+}
+
+void SdfAtlas::DrawGlyph(const PlacedGlyph &placed_glyph, float scale, SDL_Surface *surface, Uint8 alpha) {
+
+  const Glyph &glyph = *placed_glyph.glyph;
+  float cell_left = (float) (placed_glyph.pen_x + glyph.origin_x);
+  float cell_top = (float) (placed_glyph.line * line_skip_ - kSpread);
+
+  int first_x = std::max(0, (int) std::floor(cell_left * scale));
+  int last_x = std::min(surface->w, (int) std::ceil((cell_left + glyph.width) * scale));
+  int first_y = std::max(0, (int) std::floor(cell_top * scale));
+  int last_y = std::min(surface->h, (int) std::ceil((cell_top + glyph.height) * scale));
+
+  for (int y = first_y; y < last_y; y++) {
+    Uint32 *row = (Uint32 *) ((Uint8 *) surface->pixels + y * surface->pitch);
+    float cell_y = ((float) y + 0.5f) / scale - cell_top - 0.5f;
+    for (int x = first_x; x < last_x; x++) {
+
+      // A texel's distance is in reference pixels, and the edge is blurred over one pixel at the drawn size
+      float cell_x = ((float) x + 0.5f) / scale - cell_left - 0.5f;
+      float distance = SampleDistance(glyph, cell_x, cell_y) * scale;
+      float coverage = std::min(std::max(0.5f + distance, 0.0f), 1.0f);
+
+      // Neighbouring glyphs can overlap, and each pixel keeps the greater coverage
+      Uint32 pixel_alpha = (Uint32) std::lround(coverage * alpha);
+      if (pixel_alpha > row[x] >> 24) {
+        row[x] = (row[x] & 0x00FFFFFF) | (pixel_alpha << 24);
+      }
+
+    }
+  }
+
+}
+
+float SdfAtlas::SampleDistance(const Glyph &glyph, float x, float y) {
+
+  // Bilinear, clamped to the cell, whose border is always far outside the glyph
+  x = std::min(std::max(x, 0.0f), (float) (glyph.width - 1));
+  y = std::min(std::max(y, 0.0f), (float) (glyph.height - 1));
+  int x0 = (int) x;
+  int y0 = (int) y;
+  int x1 = std::min(x0 + 1, glyph.width - 1);
+  int y1 = std::min(y0 + 1, glyph.height - 1);
+  float fx = x - (float) x0;
+  float fy = y - (float) y0;
+
+  const uint8_t *cell = atlas_.data() + (std::size_t) glyph.atlas_y * atlas_width_ + glyph.atlas_x;
+  float top = cell[y0 * atlas_width_ + x0] * (1 - fx) + cell[y0 * atlas_width_ + x1] * fx;
+  float bottom = cell[y1 * atlas_width_ + x0] * (1 - fx) + cell[y1 * atlas_width_ + x1] * fx;
+  float value = top * (1 - fy) + bottom * fy;
+
+  return (value - 128) * kSpread / 127;
+
+}
+
+}
@@ -0,0 +1,12 @@
+#include "text/sdf_font.h"
+
+namespace cross_language_match {
+
+SdfFont::SdfFont(SdfAtlas *atlas, int point_size) : atlas_(atlas), point_size_(point_size) {}
+
+SDL_Surface *SdfFont::Render(const std::string &text, SDL_Color color, int wrap_length_pixels, float pixel_scale) {
+  int scaled_wrap_length_pixels = wrap_length_pixels < 0 ? -1 : (int) (wrap_length_pixels * pixel_scale);
+  return atlas_->Render(text, point_size_ * pixel_scale, color, scaled_wrap_length_pixels);
+}
+
+}
@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include "text/shaped_text_cache.h"
+
+namespace cross_language_match {
+
+ShapedTextCache::ShapedTextCache(std::size_t max_size_bytes) : max_size_bytes_(max_size_bytes) {}
+
+ShapedTextCache::~ShapedTextCache() {
+
+  SDL_FreeSurface(composed_surface_);
+  composed_surface_ = nullptr;
+
+  for (CachedRun &run : runs_) {
+    SDL_FreeSurface(run.surface);
+  }
+  runs_.clear();
+  runs_by_key_.clear();
+
+}
+
+SDL_Surface *ShapedTextCache::Render(FontChain *font_chain, const std::string &text, SDL_Color color) {
+
+  // Surfaces handed out by the previous call are no longer used, so they can go now
+  SDL_FreeSurface(composed_surface_);
+  composed_surface_ = nullptr;
+  EvictToSize();
+
+  font_chain->Segment(text, &segmented_runs_);
+  if (segmented_runs_.empty()) {
+    segmented_runs_.push_back({font_chain->GetPrimaryFont(), 0, 0, false});
+  }
+
+  std::vector<SDL_Surface *> run_surfaces;
+  for (const FontRun &run : segmented_runs_) {
+    SDL_Surface *run_surface = RenderRun(run, text, color);
+    if (run_surface == nullptr) {
+      return nullptr;
+    }
+    run_surfaces.push_back(run_surface);
+  }
+
+  // Most words need one font, and are drawn exactly as they would be without a chain
+  if (run_surfaces.size() == 1) {
+    return run_surfaces[0];
+  }
+  composed_surface_ = ComposeRuns(segmented_runs_, run_surfaces);
+  return composed_surface_;
+
+}
+
+SDL_Surface *ShapedTextCache::RenderRun(const FontRun &run, const std::string &text, SDL_Color color) {
+
+  std::string run_text = text.substr(run.begin, run.end - run.begin);
+  std::string key(reinterpret_cast<const char *>(&run.font), sizeof(run.font));
+  key.append(reinterpret_cast<const char *>(&color), sizeof(color));
+  key.append(run_text);
+
+  auto found = runs_by_key_.find(key);
+  if (found != runs_by_key_.end()) {
+    hit_count_++;
+    runs_.splice(runs_.begin(), runs_, found->second);
+    return found->second->surface;
+  }
+
+  // SDL_ttf shapes the run with HarfBuzz, in the script and direction set on its font, as part of rendering it
+  auto start_time = std::chrono::steady_clock::now();
+  SDL_Surface *surface = TTF_RenderUTF8_Blended(run.font, run_text.c_str(), color);
+  if (surface == nullptr) {
+    return nullptr;
+  }
+
+  double shaping_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+  miss_count_++;
+  total_shaping_ms_ += shaping_ms;
+  max_shaping_ms_ = std::max(max_shaping_ms_, shaping_ms);
+
+  size_bytes_ += (std::size_t) surface->pitch * surface->h;
+  runs_.push_front({key, surface});
+  runs_by_key_[key] = runs_.begin();
+  return surface;
+
+}
+
+SDL_Surface *ShapedTextCache::ComposeRuns(const std::vector<FontRun> &runs,
+                                          const std::vector<SDL_Surface *> &run_surfaces) {
+
+  int width = 0;
+  int ascent = 0;
+  for (std::size_t i = 0; i < runs.size(); i++) {
+    width += run_surfaces[i]->w;
+    ascent = std::max(ascent, TTF_FontAscent(runs[i].font));
+  }
+
+  // Fonts differ in ascent, so each run is lowered until the baselines line up
+  int height = 0;
+  for (std::size_t i = 0; i < runs.size(); i++) {
+    height = std::max(height, ascent - TTF_FontAscent(runs[i].font) + run_surfaces[i]->h);
+  }
+
+  SDL_Surface *text_surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+  if (text_surface == nullptr) {
+    return nullptr;
+  }
+
+  // Each run is laid out in its own direction by SDL_ttf; a word that starts in a right-to-left script is read from
+  // the right, so its runs are placed from the right too. This is not the full bidirectional algorithm, but covers
+  // words in one script with digits or Latin words inside them.
+  bool right_to_left = runs.front().right_to_left;
+  int x = right_to_left ? width : 0;
+  for (std::size_t i = 0; i < runs.size(); i++) {
+    if (right_to_left) {
+      x -= run_surfaces[i]->w;
+    }
+
+    // Runs do not overlap, so each is copied as it is, transparent pixels included. A texture takes its surface's
+    // blend mode, so the cached run gets its own back for when it is drawn alone.
+    SDL_SetSurfaceBlendMode(run_surfaces[i], SDL_BLENDMODE_NONE);
+    SDL_Rect dest_rect = {x, ascent - TTF_FontAscent(runs[i].font), run_surfaces[i]->w, run_surfaces[i]->h};
+    SDL_BlitSurface(run_surfaces[i], nullptr, text_surface, &dest_rect);
+    SDL_SetSurfaceBlendMode(run_surfaces[i], SDL_BLENDMODE_BLEND);
+
+    if (!right_to_left) {
+      x += run_surfaces[i]->w;
+    }
+  }
+
+  return text_surface;
+
+}
+
+void ShapedTextCache::EvictToSize() {
+
+  while (size_bytes_ > max_size_bytes_ && !runs_.empty()) {
+    CachedRun &run = runs_.back();
+    size_bytes_ -= (std::size_t) run.surface->pitch * run.surface->h;
+    SDL_FreeSurface(run.surface);
+    runs_by_key_.erase(run.key);
+    runs_.pop_back();
+    eviction_count_++;
+  }
+
+}
+
+void ShapedTextCache::PrintStats() {
+
+  uint64_t lookup_count = hit_count_ + miss_count_;
+  printf("Shaped text cache: %llu hits, %llu misses (%.1f%% hit rate), %llu evictions, %d KB held; "
+         "%.3f ms mean and %.3f ms max to shape a run\n",
+         (unsigned long long) hit_count_,
+         (unsigned long long) miss_count_,
+         lookup_count == 0 ? 0.0 : 100.0 * hit_count_ / lookup_count,
+         (unsigned long long) eviction_count_,
+         (int) (size_bytes_ / 1024),
+         miss_count_ == 0 ? 0.0 : total_shaping_ms_ / miss_count_,
+         max_shaping_ms_);
+
+}
+
+}
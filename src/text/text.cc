@@ -1,3 +1,4 @@
+#include <cmath>
 #include <string>
 #include <boost/format.hpp>
 #include <SDL_ttf.h>
@@ -5,35 +6,76 @@
 
 namespace cross_language_match {
 
-Text::Text(SDL_Renderer *renderer, TTF_Font *font, SDL_Color color, std::string text, int wrap_length_pixels)
+Text::Text(SDL_Renderer *renderer, SdfFont *font, SDL_Color color, std::string text, int wrap_length_pixels)
     : Rectangle(renderer) {
 
   renderer_ = renderer;
   text_string_ = text;
+  font_ = font;
+  color_ = color;
+  wrap_length_pixels_ = wrap_length_pixels;
 
-  SDL_Surface *text_surface;
-  if (wrap_length_pixels == -1) {
-    text_surface = TTF_RenderUTF8_Blended(font, text.c_str(), color);
+  float pixel_scale;
+  SDL_RenderGetScale(renderer_, &pixel_scale, nullptr);
+  Rasterize(pixel_scale);
+
+}
+
+Text::Text(SDL_Renderer *renderer, FontChain *font_chain, SDL_Color color, std::string text)
+    : Rectangle(renderer) {
+
+  renderer_ = renderer;
+  text_string_ = text;
+  font_chain_ = font_chain;
+  color_ = color;
+
+  float pixel_scale;
+  SDL_RenderGetScale(renderer_, &pixel_scale, nullptr);
+  Rasterize(pixel_scale);
+
+}
+
+void Text::Rasterize(float pixel_scale) {
+
+  Free();
+  pixel_scale_ = pixel_scale;
+
+  if (font_chain_ != nullptr) {
+    // The surface belongs to the cache, which shapes each run once and keeps it for the next time it is drawn
+    FontChain *font_chain = font_chain_->AtPixelScale(pixel_scale_);
+    CreateTexture(font_chain->GetShapedTextCache()->Render(font_chain, text_string_, color_));
   } else {
-    text_surface = TTF_RenderUTF8_Blended_Wrapped(font, text.c_str(), color, wrap_length_pixels);
+    SDL_Surface *text_surface = font_->Render(text_string_, color_, wrap_length_pixels_, pixel_scale_);
+    CreateTexture(text_surface);
+    SDL_FreeSurface(text_surface);
   }
+
+  // Layout is done in window coordinates, and is left as it was when the text is rasterized again: sizes in pixels
+  // may round differently at another scale, but not by enough to move anything around the text
+  if (GetWidth() == 0) {
+    Rectangle::SetWidth((int) std::ceil(texture_width_ / pixel_scale_));
+    Rectangle::SetHeight((int) std::ceil(texture_height_ / pixel_scale_));
+  }
+
+}
+
+void Text::CreateTexture(SDL_Surface *text_surface) {
+
   if (text_surface == nullptr) {
     throw std::runtime_error(
         boost::str(boost::format("Unable to render text surface, error: %1%\n") % TTF_GetError())
     );
   }
 
-  texture_ = SDL_CreateTextureFromSurface(renderer, text_surface);
+  texture_ = SDL_CreateTextureFromSurface(renderer_, text_surface);
   if (texture_ == nullptr) {
     throw std::runtime_error(
         boost::str(boost::format("Unable to create texture from surface, error: %1%\n") % SDL_GetError())
     );
   }
 
-  Rectangle::SetWidth(text_surface->w);
-  Rectangle::SetHeight(text_surface->h);
-
-  SDL_FreeSurface(text_surface);
+  texture_width_ = text_surface->w;
+  texture_height_ = text_surface->h;
 
 }
 
@@ -53,8 +95,19 @@ void Text::Free() {
 
 void Text::Render() {
 
-  SDL_Rect dest_rect = {GetTopLeftX(), GetTopLeftY(), GetWidth(), GetHeight()};
-  SDL_RenderCopy(renderer_, texture_, nullptr, &dest_rect);
+  // The scale changes when the window is moved to a display of another density
+  float pixel_scale;
+  SDL_RenderGetScale(renderer_, &pixel_scale, nullptr);
+  if (pixel_scale != pixel_scale_) {
+    Rasterize(pixel_scale);
+  }
+
+  // Drawn one texel to a pixel, however the size in window coordinates was rounded
+  SDL_FRect dest_rect = {(float) GetTopLeftX(),
+                         (float) GetTopLeftY(),
+                         texture_width_ / pixel_scale_,
+                         texture_height_ / pixel_scale_};
+  SDL_RenderCopyF(renderer_, texture_, nullptr, &dest_rect);
 
 }
 
@@ -62,6 +115,16 @@ std::string Text::GetString() const {
   return text_string_;
 }
 
+void Text::SetString(std::string text) {
+
+  text_string_ = text;
+
+  // A zero width has the size taken from the new texture
+  Rectangle::SetWidth(0);
+  Rasterize(pixel_scale_);
+
+}
+
 void Text::SetHeight(int height) {
   throw std::runtime_error("Mutating height on text object not supported; ignoring\n");
 }
@@ -0,0 +1,55 @@
+#include "text/utf8.h"
+
+namespace cross_language_match {
+
+uint32_t DecodeUtf8(const char **text) {
+
+  const unsigned char *bytes = (const unsigned char *) *text;
+  if (bytes[0] == 0) {
+    return 0;
+  }
+  if (bytes[0] < 0x80) {
+    (*text)++;
+    return bytes[0];
+  }
+
+  int length = 0;
+  uint32_t code_point = 0;
+  uint32_t min_code_point = 0;
+  if ((bytes[0] & 0xE0) == 0xC0) {
+    length = 2;
+    code_point = bytes[0] & 0x1F;
+    min_code_point = 0x80;
+  } else if ((bytes[0] & 0xF0) == 0xE0) {
+    length = 3;
+    code_point = bytes[0] & 0x0F;
+    min_code_point = 0x800;
+  } else if ((bytes[0] & 0xF8) == 0xF0) {
+    length = 4;
+    code_point = bytes[0] & 0x07;
+    min_code_point = 0x10000;
+  } else {
+    (*text)++;
+    return kReplacementCharacter;
+  }
+
+  // A NUL is not a continuation byte, so a sequence cut short by the end of the string is caught here as well
+  for (int i = 1; i < length; i++) {
+    if ((bytes[i] & 0xC0) != 0x80) {
+      (*text)++;
+      return kReplacementCharacter;
+    }
+    code_point = (code_point << 6) | (bytes[i] & 0x3F);
+  }
+
+  if (code_point < min_code_point || code_point > kMaxCodePoint || (code_point >= 0xD800 && code_point <= 0xDFFF)) {
+    (*text)++;
+    return kReplacementCharacter;
+  }
+
+  *text += length;
+  return code_point;
+
+}
+
+}
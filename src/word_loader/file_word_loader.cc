@@ -1,7 +1,13 @@
 #include <fstream>
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <sys/stat.h>
 #include <boost/format.hpp>
 #include "word_loader/file_word_loader.h"
+#include "hash/xxhash64.h"
+#include "storage/binary_io.h"
 
 namespace cross_language_match {
 
@@ -10,12 +16,29 @@ FileWordLoader::FileWordLoader(std::string file_path) {
   file_stream_ = nullptr;
 }
 
+static const char kLineIndexMagic[] = "CLMLIDX1";
+static const std::size_t kLineIndexMagicLength = 8;
+// Bytes hashed from each end of the file to recognise it without reading all of it
+static const std::size_t kSampleBytes = 64 * 1024;
+
 FileWordLoader::~FileWordLoader() {
   CloseInputStream();
+  delete range_stream_;
+  range_stream_ = nullptr;
 }
 
 std::istream &FileWordLoader::OpenInputStream() {
 
+  if (DetectCompression() == GZIP) {
+    FILE *file = fopen(file_path_.c_str(), "rb");
+    if (file == nullptr) {
+      throw std::runtime_error(boost::str(boost::format("Unable to open file %1%") % file_path_));
+    }
+    gzip_buffer_ = new GzipStreamBuffer(file);
+    gzip_stream_ = new std::istream(gzip_buffer_);
+    return *gzip_stream_;
+  }
+
   file_stream_ = new std::ifstream(file_path_);
   if (!file_stream_->is_open()) {
     throw std::runtime_error(boost::str(boost::format("Unable to open file %1%") % file_path_));
@@ -31,6 +54,14 @@ void FileWordLoader::CloseInputStream() {
   }
   delete file_stream_;
   file_stream_ = nullptr;
+
+  if (gzip_buffer_ != nullptr) {
+    decompression_failed_ = gzip_buffer_->HasFailed();
+  }
+  delete gzip_stream_;
+  gzip_stream_ = nullptr;
+  delete gzip_buffer_;
+  gzip_buffer_ = nullptr;
 }
 
 WordLoader::InputError FileWordLoader::ParseAndLoadIntoMap() {
@@ -40,7 +71,286 @@ WordLoader::InputError FileWordLoader::ParseAndLoadIntoMap() {
     return WordLoader::InputError::FILE_NOT_FOUND;
   }
 
-  return WordLoader::ParseAndLoadIntoMap();
+  if (DetectCompression() == ZSTD) {
+    // There is no Emscripten port of libzstd, so these are recognized only to be turned away with a clear message
+    return WordLoader::InputError::UNSUPPORTED_COMPRESSION;
+  }
+
+  decompression_failed_ = false;
+  WordLoader::InputError input_error = WordLoader::ParseAndLoadIntoMap();
+
+  // A file cut short usually ends in half a line, which would otherwise be reported as a missing comma
+  CloseInputStream();
+  if (decompression_failed_) {
+    return WordLoader::InputError::CORRUPT_COMPRESSED_FILE;
+  }
+
+  return input_error;
+
+}
+
+FileWordLoader::Compression FileWordLoader::DetectCompression() {
+
+  static const unsigned char gzip_magic[] = {0x1F, 0x8B};
+  static const unsigned char zstd_magic[] = {0x28, 0xB5, 0x2F, 0xFD};
+
+  unsigned char magic[sizeof(zstd_magic)] = {0};
+  FILE *file = fopen(file_path_.c_str(), "rb");
+  if (file == nullptr) {
+    return UNCOMPRESSED;
+  }
+  std::size_t read_count = fread(magic, 1, sizeof(magic), file);
+  fclose(file);
+
+  if (read_count >= sizeof(gzip_magic) && memcmp(magic, gzip_magic, sizeof(gzip_magic)) == 0) {
+    return GZIP;
+  }
+  if (read_count >= sizeof(zstd_magic) && memcmp(magic, zstd_magic, sizeof(zstd_magic)) == 0) {
+    return ZSTD;
+  }
+  return UNCOMPRESSED;
+
+}
+
+uint64_t FileWordLoader::GetFileSize() {
+  struct stat file_stat;
+  return stat(file_path_.c_str(), &file_stat) == 0 ? (uint64_t) file_stat.st_size : 0;
+}
+
+WordLoader::InputError FileWordLoader::OpenLineIndex(int stride) {
+
+  if (DetectCompression() != UNCOMPRESSED) {
+    // A compressed stream cannot be entered in the middle
+    return WordLoader::InputError::UNSUPPORTED_COMPRESSION;
+  }
+
+  if (ReadLineIndex(stride)) {
+    return WordLoader::InputError::NONE;
+  }
+
+  WordLoader::InputError input_error = BuildLineIndex(stride);
+  if (input_error == WordLoader::InputError::NONE) {
+    WriteLineIndex();
+  }
+  return input_error;
+
+}
+
+int FileWordLoader::GetLineCount() {
+  return (int) line_count_;
+}
+
+uint64_t FileWordLoader::GetLineIndexChecksum() {
+  return line_index_checksum_;
+}
+
+WordLoader::InputError FileWordLoader::ParseLineRange(int first_line,
+                                                      int line_count,
+                                                      std::vector<std::pair<std::string, std::string>> *word_pairs) {
+
+  if (range_stream_ == nullptr) {
+    range_stream_ = new std::ifstream(file_path_, std::ios::binary);
+  }
+  if (!range_stream_->is_open()) {
+    return WordLoader::InputError::FILE_NOT_FOUND;
+  }
+
+  // Seek to the indexed line at or before the range, then skip at most stride - 1 lines
+  range_stream_->clear();
+  range_stream_->seekg((std::streamoff) line_offsets_[first_line / line_index_stride_]);
+  for (int i = 0; i < first_line % line_index_stride_; i++) {
+    range_stream_->ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+  }
+
+  std::string line;
+  std::string left_word;
+  std::string right_word;
+  for (int i = 0; i < line_count && getline(*range_stream_, line); i++) {
+    WordLoader::InputError input_error = SplitLine(line, &left_word, &right_word);
+    if (input_error != WordLoader::InputError::NONE) {
+      return input_error;
+    }
+    word_pairs->emplace_back(left_word, right_word);
+  }
+
+  return WordLoader::InputError::NONE;
+
+}
+
+void FileWordLoader::SetLineIndexDirectory(std::string line_index_directory) {
+  line_index_directory_ = line_index_directory;
+}
+
+std::string FileWordLoader::GetLineIndexPath() {
+
+  if (line_index_directory_.empty()) {
+    return file_path_ + ".idx";
+  }
+
+  uint64_t sample_hash = 0;
+  ComputeSampleHash(&sample_hash);
+  return boost::str(boost::format("%1%/%2$016x.idx") % line_index_directory_ % sample_hash);
+
+}
+
+bool FileWordLoader::ComputeSampleHash(uint64_t *sample_hash) {
+
+  FILE *file = fopen(file_path_.c_str(), "rb");
+  if (file == nullptr) {
+    return false;
+  }
+
+  uint64_t file_size = GetFileSize();
+  std::vector<char> sample(std::min<uint64_t>(file_size, kSampleBytes));
+  bool read = fread(sample.data(), 1, sample.size(), file) == sample.size();
+  uint64_t hash = XxHash64(sample.data(), sample.size(), file_size);
+  if (read && file_size > kSampleBytes) {
+    read = fseeko(file, (off_t) (file_size - sample.size()), SEEK_SET) == 0
+        && fread(sample.data(), 1, sample.size(), file) == sample.size();
+    hash = XxHash64(sample.data(), sample.size(), hash);
+  }
+  fclose(file);
+
+  *sample_hash = hash;
+  return read;
+
+}
+
+uint64_t FileWordLoader::ComputeLineIndexChecksum() {
+  uint64_t header[] = {(uint64_t) line_index_stride_, indexed_file_size_, indexed_sample_hash_, line_count_};
+  uint64_t checksum = XxHash64(header, sizeof(header));
+  return XxHash64(line_offsets_.data(), line_offsets_.size() * sizeof(uint64_t), checksum);
+}
+
+bool FileWordLoader::ReadLineIndex(int stride) {
+
+  FILE *file = fopen(GetLineIndexPath().c_str(), "rb");
+  if (file == nullptr) {
+    return false;
+  }
+
+  char magic[kLineIndexMagicLength];
+  int32_t saved_stride = 0;
+  uint64_t saved_checksum = 0;
+  bool read = fread(magic, 1, kLineIndexMagicLength, file) == kLineIndexMagicLength
+      && memcmp(magic, kLineIndexMagic, kLineIndexMagicLength) == 0
+      && ReadValue(file, &saved_stride)
+      && saved_stride == stride
+      && ReadValue(file, &indexed_file_size_)
+      && ReadValue(file, &indexed_sample_hash_)
+      && ReadValue(file, &line_count_)
+      && ReadVector(file, &line_offsets_, line_count_ / stride + 1)
+      && ReadValue(file, &saved_checksum)
+      && line_offsets_.size() == (line_count_ + stride - 1) / stride;
+  fclose(file);
+
+  line_index_stride_ = stride;
+  uint64_t sample_hash = 0;
+  if (!read
+      || saved_checksum != ComputeLineIndexChecksum()
+      || indexed_file_size_ != GetFileSize()
+      || !ComputeSampleHash(&sample_hash)
+      || sample_hash != indexed_sample_hash_) {
+    printf("Line index %s is missing or stale; rebuilding it\n", GetLineIndexPath().c_str());
+    return false;
+  }
+
+  line_index_checksum_ = saved_checksum;
+  return true;
+
+}
+
+static WordLoader::InputError CheckLineCommaCount(int comma_count) {
+  if (comma_count == 0) {
+    return WordLoader::InputError::LINE_CONTAINS_NO_COMMA;
+  } else if (comma_count > 1) {
+    return WordLoader::InputError::LINE_CONTAINS_MORE_THAN_ONE_COMMA;
+  }
+  return WordLoader::InputError::NONE;
+}
+
+WordLoader::InputError FileWordLoader::BuildLineIndex(int stride) {
+
+  FILE *file = fopen(file_path_.c_str(), "rb");
+  if (file == nullptr) {
+    return WordLoader::InputError::FILE_NOT_FOUND;
+  }
+
+  line_index_stride_ = stride;
+  line_count_ = 0;
+  line_offsets_.clear();
+
+  // Lines are delimited the way getline delimits them: a final newline does not start another line
+  WordLoader::InputError input_error = WordLoader::InputError::NONE;
+  char buffer[64 * 1024];
+  uint64_t offset = 0;
+  bool at_line_start = true;
+  int line_comma_count = 0;
+  std::size_t read_count;
+  while (input_error == WordLoader::InputError::NONE && (read_count = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    for (std::size_t i = 0; i < read_count; i++, offset++) {
+
+      if (at_line_start) {
+        if (line_count_ % stride == 0) {
+          line_offsets_.push_back(offset);
+        }
+        line_count_++;
+        line_comma_count = 0;
+        at_line_start = false;
+      }
+
+      if (buffer[i] == ',') {
+        line_comma_count++;
+      } else if (buffer[i] == '\n') {
+        input_error = CheckLineCommaCount(line_comma_count);
+        if (input_error != WordLoader::InputError::NONE) {
+          break;
+        }
+        at_line_start = true;
+      }
+
+    }
+  }
+  fclose(file);
+
+  if (input_error == WordLoader::InputError::NONE && !at_line_start) {
+    input_error = CheckLineCommaCount(line_comma_count);
+  }
+  if (input_error != WordLoader::InputError::NONE) {
+    return input_error;
+  }
+
+  indexed_file_size_ = offset;
+  if (!ComputeSampleHash(&indexed_sample_hash_)) {
+    return WordLoader::InputError::FILE_NOT_FOUND;
+  }
+  line_index_checksum_ = ComputeLineIndexChecksum();
+  return WordLoader::InputError::NONE;
+
+}
+
+void FileWordLoader::WriteLineIndex() {
+
+  // A torn write is caught by the checksum on the next read, which then rebuilds the index
+  FILE *file = fopen(GetLineIndexPath().c_str(), "wb");
+  if (file == nullptr) {
+    printf("Warning: unable to save line index %s\n", GetLineIndexPath().c_str());
+    return;
+  }
+
+  int32_t stride = line_index_stride_;
+  bool written = fwrite(kLineIndexMagic, 1, kLineIndexMagicLength, file) == kLineIndexMagicLength
+      && WriteValue(file, stride)
+      && WriteValue(file, indexed_file_size_)
+      && WriteValue(file, indexed_sample_hash_)
+      && WriteValue(file, line_count_)
+      && WriteVector(file, line_offsets_)
+      && WriteValue(file, line_index_checksum_);
+  fclose(file);
+
+  if (!written) {
+    printf("Warning: unable to save line index %s\n", GetLineIndexPath().c_str());
+  }
 
 }
 
@@ -0,0 +1,85 @@
+#include <cstring>
+#include <boost/format.hpp>
+#include "word_loader/gzip_stream_buffer.h"
+
+namespace cross_language_match {
+
+// Adding 16 to the window bits makes zlib expect a gzip header and trailer rather than a raw zlib stream
+static const int kGzipWindowBits = 15 + 16;
+
+GzipStreamBuffer::GzipStreamBuffer(FILE *file)
+    : file_(file),
+      compressed_(kChunkSize),
+      decompressed_(kChunkSize) {
+
+  memset(&stream_, 0, sizeof(stream_));
+  if (inflateInit2(&stream_, kGzipWindowBits) != Z_OK) {
+    fclose(file_);
+    throw std::runtime_error(boost::str(boost::format("Unable to initialize zlib: %1%") % stream_.msg));
+  }
+
+  // Empty get area, so the first read calls underflow
+  setg(decompressed_.data(), decompressed_.data(), decompressed_.data());
+
+}
+
+GzipStreamBuffer::~GzipStreamBuffer() {
+  inflateEnd(&stream_);
+  fclose(file_);
+}
+
+bool GzipStreamBuffer::HasFailed() {
+  return failed_;
+}
+
+GzipStreamBuffer::int_type GzipStreamBuffer::underflow() {
+
+  if (gptr() < egptr()) {
+    return traits_type::to_int_type(*gptr());
+  }
+
+  stream_.next_out = reinterpret_cast<Bytef *>(decompressed_.data());
+  stream_.avail_out = (uInt) decompressed_.size();
+
+  // Inflate until at least one byte comes out; a chunk of input can be all header, or end exactly on a member boundary
+  while (!finished_ && stream_.avail_out == decompressed_.size()) {
+
+    if (stream_.avail_in == 0) {
+      std::size_t read_count = fread(compressed_.data(), 1, compressed_.size(), file_);
+      if (read_count == 0) {
+        // Ending anywhere but between members means the file was cut short
+        failed_ = !at_member_end_ || ferror(file_) != 0;
+        finished_ = true;
+        break;
+      }
+      stream_.next_in = reinterpret_cast<Bytef *>(compressed_.data());
+      stream_.avail_in = (uInt) read_count;
+    }
+
+    if (at_member_end_) {
+      inflateReset(&stream_);
+      at_member_end_ = false;
+    }
+
+    int result = inflate(&stream_, Z_NO_FLUSH);
+    if (result == Z_STREAM_END) {
+      at_member_end_ = true;
+    } else if (result != Z_OK && result != Z_BUF_ERROR) {
+      printf("Warning: corrupt gzip data: %s\n", stream_.msg != nullptr ? stream_.msg : "unknown error");
+      failed_ = true;
+      finished_ = true;
+    }
+
+  }
+
+  std::size_t produced = decompressed_.size() - stream_.avail_out;
+  if (produced == 0) {
+    return traits_type::eof();
+  }
+
+  setg(decompressed_.data(), decompressed_.data(), decompressed_.data() + produced);
+  return traits_type::to_int_type(*gptr());
+
+}
+
+}
@@ -12,24 +12,15 @@ WordLoader::InputError WordLoader::ParseAndLoadIntoMap() {
   std::istream &input_stream = OpenInputStream();
 
   std::string line;
+  std::string left_word;
+  std::string right_word;
   while (getline(input_stream, line)) {
-    std::size_t comma_occurrences = std::count(line.begin(), line.end(), ',');
-    if (comma_occurrences == 0) {
-      return WordLoader::InputError::LINE_CONTAINS_NO_COMMA;
-    } else if (comma_occurrences > 1) {
-      return WordLoader::InputError::LINE_CONTAINS_MORE_THAN_ONE_COMMA;
-    }
 
-    std::size_t comma_index = line.find(',');
-    if (comma_index == std::string::npos) {
-      throw std::runtime_error(
-          boost::str(boost::format("Improperly formatted file, line without comma found: %1%") % line)
-      );
+    WordLoader::InputError input_error = SplitLine(line, &left_word, &right_word);
+    if (input_error != WordLoader::InputError::NONE) {
+      return input_error;
     }
 
-    std::string left_word = line.substr(0, comma_index);
-    std::string right_word = line.substr(comma_index + 1);
-
     word_pairs_.insert(std::pair<std::string, std::string>(left_word, right_word));
 
   }
@@ -40,7 +31,29 @@ WordLoader::InputError WordLoader::ParseAndLoadIntoMap() {
 
 }
 
-std::map<std::string, std::string> WordLoader::GetWordPairMap() {
+WordLoader::InputError WordLoader::SplitLine(const std::string &line, std::string *left_word, std::string *right_word) {
+
+  std::size_t comma_occurrences = std::count(line.begin(), line.end(), ',');
+  if (comma_occurrences == 0) {
+    return WordLoader::InputError::LINE_CONTAINS_NO_COMMA;
+  } else if (comma_occurrences > 1) {
+    return WordLoader::InputError::LINE_CONTAINS_MORE_THAN_ONE_COMMA;
+  }
+
+  std::size_t comma_index = line.find(',');
+  if (comma_index == std::string::npos) {
+    throw std::runtime_error(
+        boost::str(boost::format("Improperly formatted file, line without comma found: %1%") % line)
+    );
+  }
+
+  left_word->assign(line, 0, comma_index);
+  right_word->assign(line, comma_index + 1, std::string::npos);
+  return WordLoader::InputError::NONE;
+
+}
+
+const std::map<std::string, std::string> &WordLoader::GetWordPairMap() {
   return word_pairs_;
 }
 